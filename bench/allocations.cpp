@@ -0,0 +1,44 @@
+#include "allocations.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace bench
+{
+std::atomic<std::size_t> live_bytes{0};
+std::atomic<std::size_t> allocations{0};
+} // namespace bench
+
+// Each allocation is prefixed with its size.
+static constexpr std::size_t size_prefix = alignof(std::max_align_t);
+
+void* operator new(std::size_t size)
+{
+	auto* const block =
+		static_cast<unsigned char*>(std::malloc(size + size_prefix));
+	if (block == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	*reinterpret_cast<std::size_t*>(block) = size;
+	bench::live_bytes.fetch_add(size, std::memory_order_relaxed);
+	bench::allocations.fetch_add(1, std::memory_order_relaxed);
+	return block + size_prefix;
+}
+
+void operator delete(void* pointer) noexcept
+{
+	if (pointer == nullptr)
+	{
+		return;
+	}
+	auto* const block = static_cast<unsigned char*>(pointer) - size_prefix;
+	bench::live_bytes.fetch_sub(
+		*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+	std::free(block);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	operator delete(pointer);
+}
@@ -0,0 +1,19 @@
+#ifndef JSH_BENCH_ALLOCATIONS_HPP_INCLUDED
+#define JSH_BENCH_ALLOCATIONS_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * The benchmarks replace the global allocation functions to count the bytes
+ * held by live allocations and the number of allocations made, so they can
+ * report how much memory a parsed tree occupies and how often parsing
+ * allocates.
+ */
+namespace bench
+{
+extern std::atomic<std::size_t> live_bytes;
+extern std::atomic<std::size_t> allocations;
+} // namespace bench
+
+#endif
@@ -0,0 +1,51 @@
+#include "jsonish/diff.hpp"
+#include "jsonish/document.hpp"
+#include "jsonish/parse.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+static
+std::string make_records(std::size_t count)
+{
+	std::string document = "[\n";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		document += i == 0 ? "" : ",\n";
+		document += R"(    {"name" : "record )" + std::to_string(i)
+			+ R"(", "tags" : ["x", "y"], "enabled" : "yes"})";
+	}
+	document += "\n]\n";
+	return document;
+}
+
+// Diff a large value against a copy with one record edited in place.
+static
+void BM_diff_shared(benchmark::State& state)
+{
+	jsonish::Document document(make_records(5000));
+	auto const before = document.value();
+	document.edit(document.text().find("record 2500"), 1, "R");
+	auto const after = document.value();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::diff(before, after));
+	}
+}
+BENCHMARK(BM_diff_shared);
+
+// The same edit, with both values parsed separately so nothing is shared.
+static
+void BM_diff_unshared(benchmark::State& state)
+{
+	auto text = make_records(5000);
+	auto const before = jsonish::parse(text).value();
+	text[text.find("record 2500")] = 'R';
+	auto const after = jsonish::parse(text).value();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::diff(before, after));
+	}
+}
+BENCHMARK(BM_diff_unshared);
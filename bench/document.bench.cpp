@@ -0,0 +1,52 @@
+#include "jsonish/document.hpp"
+#include "jsonish/parse.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+// A list of records, as in a configuration file being edited.
+static
+std::string make_records(std::size_t count)
+{
+	std::string document = "[\n";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		document += i == 0 ? "" : ",\n";
+		document += R"(    {"name" : "record )" + std::to_string(i)
+			+ R"(", "tags" : ["x", "y"], "enabled" : "yes"})";
+	}
+	document += "\n]\n";
+	return document;
+}
+
+// Type a character into a record in the middle of the document and undo it.
+static
+void BM_document_edit(benchmark::State& state)
+{
+	jsonish::Document document(make_records(5000));
+	auto const offset =
+		document.text().find("record 2500") + std::string("record").size();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(document.edit(offset, 0, "x"));
+		benchmark::DoNotOptimize(document.edit(offset, 1, ""));
+	}
+}
+BENCHMARK(BM_document_edit);
+
+// The same, parsing the whole text after each edit.
+static
+void BM_document_full_parse(benchmark::State& state)
+{
+	auto text = make_records(5000);
+	auto const offset = text.find("record 2500") + std::string("record").size();
+	for (auto _ : state)
+	{
+		text.insert(offset, 1, 'x');
+		benchmark::DoNotOptimize(jsonish::parse(text));
+		text.erase(offset, 1);
+		benchmark::DoNotOptimize(jsonish::parse(text));
+	}
+}
+BENCHMARK(BM_document_full_parse);
@@ -0,0 +1,63 @@
+#include "jsonish/index.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+static
+jsonish::Value make_records(std::size_t count)
+{
+	jsonish::List list;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		jsonish::Object record;
+		record.set_property("id", "record-" + std::to_string(i));
+		record.set_property("enabled", "yes");
+		list.append(jsonish::Value(std::move(record)));
+	}
+	return jsonish::Value(std::move(list));
+}
+
+// Find a record by scanning, as without an index.
+static
+void BM_index_scan(benchmark::State& state)
+{
+	auto const records = make_records(100000);
+	for (auto _ : state)
+	{
+		for (auto const& record : records.as_list())
+		{
+			if (record.property("id").as_value().as_string() == "record-77777")
+			{
+				benchmark::DoNotOptimize(record);
+				break;
+			}
+		}
+	}
+}
+BENCHMARK(BM_index_scan);
+
+static
+void BM_index_find(benchmark::State& state)
+{
+	jsonish::Index const index(make_records(100000), "id");
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(index.find("record-77777"));
+	}
+}
+BENCHMARK(BM_index_find);
+
+// Build an index with the number of threads given as the argument.
+static
+void BM_index_build(benchmark::State& state)
+{
+	auto const records = make_records(1000000);
+	for (auto _ : state)
+	{
+		jsonish::Index const index(
+			records, "id", static_cast<std::size_t>(state.range(0)));
+		benchmark::DoNotOptimize(index.size());
+	}
+}
+BENCHMARK(BM_index_build)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
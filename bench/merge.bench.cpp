@@ -0,0 +1,102 @@
+#include "jsonish/merge.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+// Defaults with many sections, then layers that each override a few keys.
+static
+std::vector<jsonish::Value> make_layers(std::size_t count)
+{
+	jsonish::Object defaults;
+	for (int i = 0; i < 200; ++i)
+	{
+		jsonish::Object section;
+		for (int j = 0; j < 20; ++j)
+		{
+			section.set_property(
+				"key_" + std::to_string(j),
+				"default value " + std::to_string(j));
+		}
+		defaults.set_property("section_" + std::to_string(i), section);
+	}
+
+	std::vector<jsonish::Value> layers{jsonish::Value(std::move(defaults))};
+	for (std::size_t i = 1; i < count; ++i)
+	{
+		jsonish::Object section;
+		section.set_property("key_" + std::to_string(i % 20), "override");
+		jsonish::Object layer;
+		layer.set_property(
+			"section_" + std::to_string(i * 37 % 200), std::move(section));
+		layers.emplace_back(std::move(layer));
+	}
+	return layers;
+}
+
+// Merge by rebuilding every object, as a loop of `set_property` calls does.
+static
+jsonish::Value merge_by_copying(
+	jsonish::Value const& below, jsonish::Value const& above)
+{
+	if (!below.is_object() || !above.is_object())
+	{
+		return above;
+	}
+	jsonish::Object merged;
+	for (auto const& [key, value] : below.as_object())
+	{
+		merged.set_property(key, merge_by_copying(value, jsonish::Object()));
+	}
+	for (auto const& [key, value] : above.as_object())
+	{
+		auto const existing = merged.property(key);
+		merged.set_property(
+			key,
+			existing.exists()
+				? merge_by_copying(existing.as_value(), value)
+				: value);
+	}
+	return jsonish::Value(std::move(merged));
+}
+
+static
+void BM_merge_copying(benchmark::State& state)
+{
+	auto const layers = make_layers(24);
+	for (auto _ : state)
+	{
+		auto merged = layers.front();
+		for (std::size_t i = 1; i < layers.size(); ++i)
+		{
+			merged = merge_by_copying(merged, layers[i]);
+		}
+		benchmark::DoNotOptimize(merged);
+	}
+}
+BENCHMARK(BM_merge_copying);
+
+static
+void BM_merge(benchmark::State& state)
+{
+	auto const layers = make_layers(24);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::merge(layers));
+	}
+}
+BENCHMARK(BM_merge);
+
+// Read one setting through the layers without merging them.
+static
+void BM_merge_overlay_lookup(benchmark::State& state)
+{
+	jsonish::Overlay const overlay(make_layers(24));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(
+			overlay.property("section_37").property("key_1").value());
+	}
+}
+BENCHMARK(BM_merge_overlay_lookup);
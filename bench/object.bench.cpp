@@ -0,0 +1,199 @@
+#include "jsonish/tree.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Members = std::vector<std::pair<std::string, jsonish::Value>>;
+
+/*
+ * Benchmarks take the number of members as their first argument and, for
+ * `jsonish::Object`, the `jsonish::ObjectStorage` as their second.
+ */
+
+// Make members with keys of realistic length, in shuffled order.
+static
+Members make_members(std::size_t count)
+{
+	Members members;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		members.emplace_back(
+			"member_" + std::to_string(i * 7919 % 100003), "value");
+	}
+	std::shuffle(
+		std::begin(members), std::end(members), std::mt19937(count));
+	return members;
+}
+
+static
+std::map<std::string, jsonish::Value> make_map(Members const& members)
+{
+	std::map<std::string, jsonish::Value> map;
+	for (auto const& [key, value] : members)
+	{
+		map.emplace(key, value);
+	}
+	return map;
+}
+
+static
+jsonish::Object make_object(Members members, benchmark::State const& state)
+{
+	jsonish::Object object(
+		static_cast<jsonish::ObjectStorage>(state.range(1)));
+	(void)object.assign(std::move(members));
+	return object;
+}
+
+static
+void BM_build_map(benchmark::State& state)
+{
+	auto const members =
+		make_members(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		auto map = make_map(members);
+		benchmark::DoNotOptimize(map);
+	}
+}
+
+static
+void BM_build_object(benchmark::State& state)
+{
+	auto const members =
+		make_members(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+	{
+		auto object = make_object(members, state);
+		benchmark::DoNotOptimize(object);
+	}
+}
+
+static
+void BM_lookup_map(benchmark::State& state)
+{
+	auto const members =
+		make_members(static_cast<std::size_t>(state.range(0)));
+	auto const map = make_map(members);
+	for (auto _ : state)
+	{
+		for (auto const& member : members)
+		{
+			benchmark::DoNotOptimize(map.find(member.first));
+		}
+	}
+	state.SetItemsProcessed(
+		static_cast<std::int64_t>(state.iterations() * members.size()));
+}
+
+static
+void BM_lookup_object(benchmark::State& state)
+{
+	auto const members =
+		make_members(static_cast<std::size_t>(state.range(0)));
+	auto const object = make_object(members, state);
+	for (auto _ : state)
+	{
+		for (auto const& member : members)
+		{
+			benchmark::DoNotOptimize(object.property(member.first));
+		}
+	}
+	state.SetItemsProcessed(
+		static_cast<std::int64_t>(state.iterations() * members.size()));
+}
+
+// Look up keys prepared once, as a request handler would.
+static
+void BM_lookup_object_handle(benchmark::State& state)
+{
+	auto const members =
+		make_members(static_cast<std::size_t>(state.range(0)));
+	auto const object = make_object(members, state);
+
+	std::vector<jsonish::KeyHandle> handles;
+	for (auto const& member : members)
+	{
+		handles.emplace_back(member.first);
+	}
+
+	for (auto _ : state)
+	{
+		for (auto const& handle : handles)
+		{
+			benchmark::DoNotOptimize(object.property(handle));
+		}
+	}
+	state.SetItemsProcessed(
+		static_cast<std::int64_t>(state.iterations() * members.size()));
+}
+
+static
+void BM_iterate_map(benchmark::State& state)
+{
+	auto const map =
+		make_map(make_members(static_cast<std::size_t>(state.range(0))));
+	for (auto _ : state)
+	{
+		std::size_t total = 0;
+		for (auto const& [key, value] : map)
+		{
+			total += key.size() + value.as_string().size();
+		}
+		benchmark::DoNotOptimize(total);
+	}
+}
+
+static
+void BM_iterate_object(benchmark::State& state)
+{
+	auto const object = make_object(
+		make_members(static_cast<std::size_t>(state.range(0))), state);
+	for (auto _ : state)
+	{
+		std::size_t total = 0;
+		for (auto const& [key, value] : object)
+		{
+			total += key.size() + value.as_string().size();
+		}
+		benchmark::DoNotOptimize(total);
+	}
+}
+
+static
+void map_sizes(benchmark::internal::Benchmark* b)
+{
+	for (auto const size : {4, 16, 64, 1024})
+	{
+		b->Args({size});
+	}
+}
+
+static
+void object_sizes(benchmark::internal::Benchmark* b)
+{
+	b->ArgNames({"members", "storage"});
+	for (auto const size : {4, 16, 64, 1024})
+	{
+		for (auto const storage : {
+			jsonish::ObjectStorage::sorted,
+			jsonish::ObjectStorage::hashed})
+		{
+			b->Args({size, static_cast<std::int64_t>(storage)});
+		}
+	}
+}
+
+BENCHMARK(BM_build_map)->Apply(map_sizes);
+BENCHMARK(BM_build_object)->Apply(object_sizes);
+BENCHMARK(BM_lookup_map)->Apply(map_sizes);
+BENCHMARK(BM_lookup_object)->Apply(object_sizes);
+BENCHMARK(BM_lookup_object_handle)->Apply(object_sizes);
+BENCHMARK(BM_iterate_map)->Apply(map_sizes);
+BENCHMARK(BM_iterate_object)->Apply(object_sizes);
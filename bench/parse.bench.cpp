@@ -0,0 +1,193 @@
+#include "allocations.hpp"
+
+#include "jsonish/padded_string.hpp"
+#include "jsonish/parse.hpp"
+#include "jsonish/parse_many.hpp"
+#include "jsonish/projection.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Indented records with medium length strings, as in configuration files.
+static
+std::string make_document(std::size_t count)
+{
+	std::string document = "[\n";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto const n = std::to_string(i);
+		document += i == 0 ? "" : ",\n";
+		document += "    {\n        \"name\" : \"a somewhat longer name " + n
+			+ "\",\n        \"description\" : \"text that is long enough to "
+			"be scanned a word at a time\",\n        \"tags\" : [\"x\", \"y\"]"
+			"\n    }";
+	}
+	document += "\n]\n";
+	return document;
+}
+
+static
+void BM_parse_unpadded(benchmark::State& state)
+{
+	auto const document = make_document(1000);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document));
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_parse_unpadded);
+
+static
+void BM_parse_padded(benchmark::State& state)
+{
+	jsonish::PaddedString const document{
+		std::string_view(make_document(1000))};
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document));
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_parse_padded);
+
+// A small request body, as handled one at a time by a server.
+static constexpr std::string_view small_document = R"({
+    "method" : "update",
+    "id" : "7c1d2e9a-4b5f-4e3a-9d21-0f8b6a5c3e17",
+    "params" : {"user" : "someone", "fields" : ["name", "email"]},
+    "flags" : ["dry-run"]
+})";
+
+// Report the allocations made per parse, along with the throughput.
+static
+void report(benchmark::State& state, std::size_t allocations_before)
+{
+	state.SetBytesProcessed(static_cast<std::int64_t>(
+		state.iterations() * small_document.size()));
+	state.counters["allocations"] = benchmark::Counter(
+		static_cast<double>(bench::allocations.load() - allocations_before),
+		benchmark::Counter::kAvgIterations);
+}
+
+static
+void BM_parse_small_fresh(benchmark::State& state)
+{
+	auto const before = bench::allocations.load();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(small_document));
+	}
+	report(state, before);
+}
+BENCHMARK(BM_parse_small_fresh);
+
+static
+void BM_parse_small_reused(benchmark::State& state)
+{
+	jsonish::Parser parser;
+	(void)parser.parse(small_document);
+
+	auto const before = bench::allocations.load();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(parser.parse(small_document));
+	}
+	report(state, before);
+}
+BENCHMARK(BM_parse_small_reused);
+
+// Many small documents along with a few large ones.
+static
+std::vector<std::string> make_batch(void)
+{
+	std::vector<std::string> batch(2000, std::string(small_document));
+	for (std::size_t i = 0; i < batch.size(); i += 500)
+	{
+		batch[i] = make_document(500);
+	}
+	return batch;
+}
+
+static
+void BM_parse_batch_loop(benchmark::State& state)
+{
+	auto const batch = make_batch();
+	for (auto _ : state)
+	{
+		for (auto const& document : batch)
+		{
+			benchmark::DoNotOptimize(jsonish::parse(document));
+		}
+	}
+}
+BENCHMARK(BM_parse_batch_loop)->Unit(benchmark::kMillisecond);
+
+static
+void BM_parse_many(benchmark::State& state)
+{
+	auto const batch = make_batch();
+	std::vector<std::string_view> const documents(
+		std::begin(batch), std::end(batch));
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse_many(documents));
+	}
+}
+BENCHMARK(BM_parse_many)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Build only the first record of a large document, skipping the rest.
+static
+void BM_parse_projected(benchmark::State& state)
+{
+	auto const document = make_document(1000);
+	jsonish::Projection const projection({jsonish::Path{std::size_t(0)}});
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document, projection));
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_parse_projected);
+
+// Parse the same document as above within limits it does not reach.
+static
+void BM_parse_limited(benchmark::State& state)
+{
+	auto const document = make_document(1000);
+	jsonish::ParseOptions options;
+	options.limits.max_input_bytes = 1 << 20;
+	options.limits.max_depth = 64;
+	options.limits.max_string_length = 1 << 10;
+	options.limits.max_nodes = 1 << 20;
+	options.limits.max_members = 1 << 10;
+	options.limits.max_allocated_bytes = 1 << 24;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document, options));
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_parse_limited);
+
+// Reject a document nested far too deeply, as sent by an attacker.
+static
+void BM_parse_too_deep(benchmark::State& state)
+{
+	auto const document =
+		std::string(1 << 20, '[') + std::string(1 << 20, ']');
+	jsonish::ParseOptions options;
+	options.limits.max_depth = 64;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document, options));
+	}
+}
+BENCHMARK(BM_parse_too_deep);
@@ -0,0 +1,49 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/shared_document.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+
+static constexpr char const* config =
+	R"({"server" : {"port" : "8080", "host" : "localhost"}, "debug" : "no"})";
+
+// Reading a value guarded by a mutex, as the baseline.
+static
+void BM_read_with_mutex(benchmark::State& state)
+{
+	static std::mutex mutex;
+	static jsonish::Value const value = jsonish::parse(config).value();
+	for (auto _ : state)
+	{
+		std::lock_guard<std::mutex> const lock(mutex);
+		benchmark::DoNotOptimize(value.property("server").property("port"));
+	}
+}
+BENCHMARK(BM_read_with_mutex)->ThreadRange(1, 8)->UseRealTime();
+
+static
+void BM_read_shared_document(benchmark::State& state)
+{
+	static jsonish::SharedDocument const document(
+		jsonish::parse(config).value());
+	for (auto _ : state)
+	{
+		auto const reader = document.read();
+		benchmark::DoNotOptimize(reader->property("server").property("port"));
+	}
+}
+BENCHMARK(BM_read_shared_document)->ThreadRange(1, 8)->UseRealTime();
+
+// Copying the value touches its reference count, which all threads share.
+static
+void BM_snapshot_shared_document(benchmark::State& state)
+{
+	static jsonish::SharedDocument const document(
+		jsonish::parse(config).value());
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(document.snapshot());
+	}
+}
+BENCHMARK(BM_snapshot_shared_document)->ThreadRange(1, 8)->UseRealTime();
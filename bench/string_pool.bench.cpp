@@ -0,0 +1,68 @@
+#include "allocations.hpp"
+
+#include "jsonish/parse.hpp"
+#include "jsonish/string_pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+// Records whose long values mostly come from a small set, like enum values.
+static
+std::string make_records(std::size_t count)
+{
+	static char const* const states[] = {
+		"waiting for a response", "completed successfully",
+		"failed with a retryable error"};
+
+	std::string document = "[";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		document += i == 0 ? "" : ", ";
+		document += R"({"id" : ")" + std::to_string(i)
+			+ R"(", "state" : ")" + states[i % 3]
+			+ R"(", "region" : "europe-west-north-1"})";
+	}
+	document += ']';
+	return document;
+}
+
+// Report the memory held by one tree, measured outside of the timed loop.
+template <typename Parse>
+static
+void report_tree_bytes(benchmark::State& state, Parse parse)
+{
+	auto const before = bench::live_bytes.load();
+	auto const value = parse();
+	state.counters["tree_bytes"] =
+		static_cast<double>(bench::live_bytes.load() - before);
+}
+
+static
+void BM_parse_unpooled(benchmark::State& state)
+{
+	auto const document = make_records(10000);
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(jsonish::parse(document));
+	}
+	report_tree_bytes(state, [&]() { return jsonish::parse(document); });
+}
+BENCHMARK(BM_parse_unpooled);
+
+static
+void BM_parse_pooled(benchmark::State& state)
+{
+	auto const document = make_records(10000);
+	for (auto _ : state)
+	{
+		jsonish::StringPool pool;
+		benchmark::DoNotOptimize(jsonish::parse(document, pool));
+	}
+
+	jsonish::StringPool pool;
+	report_tree_bytes(state, [&]() { return jsonish::parse(document, pool); });
+	state.counters["bytes_saved"] =
+		static_cast<double>(pool.stats().bytes_saved);
+}
+BENCHMARK(BM_parse_pooled);
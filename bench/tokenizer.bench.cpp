@@ -0,0 +1,54 @@
+#include "jsonish/lex.hpp"
+#include "jsonish/tokenizer.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+// Records with short keys and values, some of them escaped.
+static
+std::string make_document(std::size_t count)
+{
+	std::string document = "[";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto const n = std::to_string(i);
+		document += i == 0 ? "" : ", ";
+		document += R"({"id": ")" + n + R"(", "path": "C:\\dir\\)" + n
+			+ R"(", "tags": ["a", "b", "c"]})";
+	}
+	document += ']';
+	return document;
+}
+
+static
+void BM_lexer_tokens(benchmark::State& state)
+{
+	auto const document = make_document(1000);
+	for (auto _ : state)
+	{
+		jsonish::Lexer lex(document);
+		while (!lex.try_extract_token(jsonish::TokenType::eof))
+		{
+			benchmark::DoNotOptimize(lex.extract_token());
+		}
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_lexer_tokens);
+
+static
+void BM_compact_tokens(benchmark::State& state)
+{
+	auto const document = make_document(1000);
+	jsonish::Tokenizer tokenizer;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(tokenizer.tokenize(document));
+		benchmark::DoNotOptimize(tokenizer.tokens().data());
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+BENCHMARK(BM_compact_tokens);
@@ -0,0 +1,127 @@
+#include "jsonish/padded_string.hpp"
+#include "jsonish/parse_options.hpp"
+#include "jsonish/unescape.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <string_view>
+
+// Build the contents of a string by repeating `piece`, then close it.
+static
+std::string make_corpus(std::string_view piece, std::size_t repetitions)
+{
+	std::string corpus;
+	corpus.reserve(piece.size() * repetitions + 1);
+	for (std::size_t i = 0; i < repetitions; ++i)
+	{
+		corpus += piece;
+	}
+	corpus += '"';
+	return corpus;
+}
+
+static
+void run_unescape(
+	benchmark::State& state,
+	std::string const& corpus,
+	bool validate_utf8 = false,
+	bool padded = false)
+{
+	std::string out;
+	if (jsonish::unescape_string(corpus, out, validate_utf8)
+		.error.has_value())
+	{
+		state.SkipWithError("corpus is not a valid string");
+		return;
+	}
+
+	jsonish::PaddedString const padded_corpus{std::string_view(corpus)};
+	auto const unescape = padded
+		? jsonish::unescape_padded_string
+		: jsonish::unescape_string;
+	for (auto _ : state)
+	{
+		out.clear();
+		auto result = unescape(
+			padded_corpus.view(), out, validate_utf8, jsonish::no_limit);
+		benchmark::DoNotOptimize(result);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * corpus.size()));
+}
+
+// Plain text without any escapes, with and without padding.
+static
+void BM_unescape_ascii(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus("the quick brown fox jumps over the lazy dog ", 256),
+		false,
+		state.range(0) != 0);
+}
+BENCHMARK(BM_unescape_ascii)->Arg(0)->Arg(1);
+
+// Text with frequent single-character escapes, as in quoted log lines.
+static
+void BM_unescape_control(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus(R"(\"key\":\t\"value\"\n\\path\/to\/file\r\n)", 256));
+}
+BENCHMARK(BM_unescape_control);
+
+// Japanese text written entirely as '\u' escapes.
+static
+void BM_unescape_i18n_bmp(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus(
+			R"(\u65e5\u672c\u8a9e\u306e\u30c6\u30ad\u30b9\u30c8 )", 256));
+}
+BENCHMARK(BM_unescape_i18n_bmp);
+
+// Emoji and other astral characters written as surrogate pairs.
+static
+void BM_unescape_i18n_surrogates(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus(
+			R"(\ud83d\ude00\ud83c\udf89\ud834\udd1e\ud840\udc0b )", 256));
+}
+BENCHMARK(BM_unescape_i18n_surrogates);
+
+// Mostly plain text with an occasional escaped character.
+static
+void BM_unescape_mixed(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus(
+			R"(Preferences for caf\u00e9 \u2014 )"
+			R"(\"na\u00efve\" r\u00e9sum\u00e9 )",
+			256));
+}
+BENCHMARK(BM_unescape_mixed);
+
+// Raw UTF-8 text in several scripts, with and without validation and
+// padding.
+static
+void BM_unescape_raw_utf8(benchmark::State& state)
+{
+	run_unescape(
+		state,
+		make_corpus(
+			"Pr\xc3\xa9" "f\xc3\xa9rences \xe6\x97\xa5\xe6\x9c\xac "
+			"\xf0\x9f\x98\x80 plain ascii text in between ",
+			256),
+		state.range(0) != 0,
+		state.range(1) != 0);
+}
+BENCHMARK(BM_unescape_raw_utf8)
+	->Args({0, 0})->Args({1, 0})->Args({0, 1})->Args({1, 1});
@@ -0,0 +1,122 @@
+#include "allocations.hpp"
+
+#include "jsonish/parse.hpp"
+#include "jsonish/tree.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+// A list of short strings, as in tags or identifiers.
+static
+std::string make_strings(std::size_t count)
+{
+	std::string document = "[";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		document += i == 0 ? "\"" : ", \"";
+		document += "item" + std::to_string(i);
+		document += '"';
+	}
+	document += ']';
+	return document;
+}
+
+// A list of small records with nested lists.
+static
+std::string make_records(std::size_t count)
+{
+	std::string document = "[";
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		auto const n = std::to_string(i);
+		document += i == 0 ? "" : ", ";
+		document += R"({"id": ")" + n + R"(", "name": "user )" + n
+			+ R"(", "email": "user)" + n + R"(@example.com",)"
+			+ R"( "tags": ["a", "b", "c"], "scores": [")" + n
+			+ R"(", "0", "100"]})";
+	}
+	document += ']';
+	return document;
+}
+
+// Add up the sizes of every string in a value.
+static
+std::size_t traverse(jsonish::Value const& value)
+{
+	if (value.is_string())
+	{
+		return value.as_string().size();
+	}
+
+	std::size_t total = 0;
+	if (value.is_list())
+	{
+		for (auto const& element : value.as_list())
+		{
+			total += traverse(element);
+		}
+		return total;
+	}
+	for (auto const& [key, member] : value.as_object())
+	{
+		total += key.size() + traverse(member);
+	}
+	return total;
+}
+
+static
+void run_parse(benchmark::State& state, std::string const& document)
+{
+	for (auto _ : state)
+	{
+		auto value = jsonish::parse(document);
+		benchmark::DoNotOptimize(value);
+	}
+
+	// Measure the memory held by one tree, outside of the timed loop.
+	auto const before = bench::live_bytes.load();
+	auto const value = jsonish::parse(document).value();
+	state.counters["tree_bytes"] =
+		static_cast<double>(bench::live_bytes.load() - before);
+	state.SetBytesProcessed(
+		static_cast<std::int64_t>(state.iterations() * document.size()));
+}
+
+static
+void run_traverse(benchmark::State& state, std::string const& document)
+{
+	auto const value = jsonish::parse(document).value();
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(traverse(value));
+	}
+}
+
+static
+void BM_parse_strings(benchmark::State& state)
+{
+	run_parse(state, make_strings(10000));
+}
+BENCHMARK(BM_parse_strings);
+
+static
+void BM_parse_records(benchmark::State& state)
+{
+	run_parse(state, make_records(1000));
+}
+BENCHMARK(BM_parse_records);
+
+static
+void BM_traverse_strings(benchmark::State& state)
+{
+	run_traverse(state, make_strings(10000));
+}
+BENCHMARK(BM_traverse_strings);
+
+static
+void BM_traverse_records(benchmark::State& state)
+{
+	run_traverse(state, make_records(1000));
+}
+BENCHMARK(BM_traverse_records);
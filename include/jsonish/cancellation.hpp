@@ -0,0 +1,41 @@
+#ifndef JSH_CANCELLATION_HPP_INCLUDED
+#define JSH_CANCELLATION_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+
+namespace jsonish
+{
+/** Lets one thread ask a parse running on another to stop.
+ *
+ * Copies of a token share one flag, so a token can be handed to a parse and
+ * a copy kept to cancel it. A parser checks the flag each time it starts a
+ * list or object, and stops with a `ErrorCode::cancelled` error once it is
+ * set. Strings are never interrupted.
+ */
+class CancellationToken
+{
+public:
+	CancellationToken(void) :
+		cancelled_(std::make_shared<std::atomic<bool>>(false))
+	{}
+
+	/// Ask every parse using this token to stop.
+	void cancel(void) noexcept
+	{
+		cancelled_->store(true, std::memory_order_relaxed);
+	}
+
+	/// Indicate whether `cancel` has been called on this token or a copy.
+	[[nodiscard]]
+	bool is_cancelled(void) const noexcept
+	{
+		return cancelled_->load(std::memory_order_relaxed);
+	}
+
+private:
+	std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+} // namespace jsonish
+
+#endif
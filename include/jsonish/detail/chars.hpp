@@ -0,0 +1,190 @@
+#ifndef JSH_DETAIL_CHARS_HPP_INCLUDED
+#define JSH_DETAIL_CHARS_HPP_INCLUDED
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Character classification and decoding helpers shared by the runtime lexer
+ * and the constexpr parser for static documents. Everything here is usable in
+ * constant expressions.
+ */
+namespace jsonish::detail
+{
+[[nodiscard]] constexpr
+bool is_space(char c) noexcept
+{
+	switch (c)
+	{
+	case ' ': case '\t': case '\n': case '\r':
+		return true;
+	default:
+		return false;
+	}
+}
+
+// This character can follow a backslash in a string.
+[[nodiscard]] constexpr
+bool is_escapable(char c) noexcept
+{
+	switch (c)
+	{
+	case '"': case '\\': case '/':
+	case 'b': case 'f': case 'n': case 'r': case 't': case 'u':
+		return true;
+	default:
+		return false;
+	}
+}
+
+// This character is not allowed at all in a string.
+[[nodiscard]] constexpr
+bool is_disallowed_in_string(char c) noexcept
+{
+	return static_cast<unsigned char>(c) < 0x20;
+}
+
+[[nodiscard]] constexpr
+bool is_ascii(char c) noexcept
+{
+	return static_cast<unsigned char>(c) < 0x80;
+}
+
+/*
+ * Map an escaped character to the character it represents. For example, 'n' is
+ * mapped to a newline character and a backslash is mapped to itself. If the
+ * character is not escapable by itself, it is mapped to a null character. It
+ * is expected that this never be the case.
+ */
+[[nodiscard]] constexpr
+char map_escaped_char(char c) noexcept
+{
+	assert(is_escapable(c) && c != 'u');
+
+	switch (c)
+	{
+	case '"': return '"';
+	case '\\': return '\\';
+	case '/': return '/';
+	case 'b': return '\b';
+	case 'f': return '\f';
+	case 'n': return '\n';
+	case 'r': return '\r';
+	case 't': return '\t';
+	default: return '\0';
+	}
+}
+
+/*
+ * Build a table mapping every character to its value as a hex digit, or to -1
+ * if it is not a hex digit.
+ */
+[[nodiscard]] constexpr
+std::array<std::int8_t, 256> make_hex_digit_table(void) noexcept
+{
+	std::array<std::int8_t, 256> table{};
+	for (auto& value : table)
+	{
+		value = -1;
+	}
+	for (std::int8_t i = 0; i < 10; ++i)
+	{
+		table[static_cast<std::size_t>('0' + i)] = i;
+	}
+	for (std::int8_t i = 0; i < 6; ++i)
+	{
+		table[static_cast<std::size_t>('a' + i)] =
+			static_cast<std::int8_t>(10 + i);
+		table[static_cast<std::size_t>('A' + i)] =
+			static_cast<std::int8_t>(10 + i);
+	}
+	return table;
+}
+
+inline constexpr auto hex_digit_values = make_hex_digit_table();
+
+// Get the value of `c` as a hex digit, or -1 if it is not one.
+[[nodiscard]] constexpr
+int hex_digit_value(char c) noexcept
+{
+	return hex_digit_values[static_cast<unsigned char>(c)];
+}
+
+[[nodiscard]] constexpr
+bool is_high_surrogate(std::uint32_t unit) noexcept
+{
+	return 0xd800 <= unit && unit <= 0xdbff;
+}
+
+[[nodiscard]] constexpr
+bool is_low_surrogate(std::uint32_t unit) noexcept
+{
+	return 0xdc00 <= unit && unit <= 0xdfff;
+}
+
+// Combine a high and low surrogate into the code point they represent.
+[[nodiscard]] constexpr
+std::uint32_t combine_surrogates(
+	std::uint32_t high, std::uint32_t low) noexcept
+{
+	assert(is_high_surrogate(high) && is_low_surrogate(low));
+	return 0x10000 + ((high - 0xd800) << 10) + (low - 0xdc00);
+}
+
+/*
+ * Get, from `value`, the range of bits [first, first + n). This starts from
+ * the least significant bit, which is considered to have index 0.
+ *
+ * The result has the bottom `n` digits set to the range and the rest set to
+ * zero. `n` absolutely must be less than or equal to 8.
+ */
+[[nodiscard]] constexpr
+unsigned get_bit_range(
+	std::uint32_t value, std::size_t first, std::size_t n) noexcept
+{
+	assert(n <= 8 && first < sizeof(value) * 8);
+	return (value >> first) & ((1u << n) - 1);
+}
+
+/*
+ * Encode `code_point` as utf-8, calling `push` with each byte as a `char`.
+ * Lone surrogates are just treated as if they are valid.
+ */
+template <typename Push>
+constexpr
+void encode_utf8(std::uint32_t code_point, Push&& push)
+{
+	auto const push_byte = [&push](unsigned byte) {
+		push(static_cast<char>(byte));
+	};
+
+	// Base of trailing byte for any multibyte character.
+	constexpr unsigned trailing_byte = 0b10000000;
+	if (code_point < 0x80)
+	{
+		push_byte(code_point);
+	}
+	else if (code_point < 0x800)
+	{
+		push_byte(0b11000000 | get_bit_range(code_point, 6, 5));
+		push_byte(trailing_byte | get_bit_range(code_point, 0, 6));
+	}
+	else if (code_point < 0x10000)
+	{
+		push_byte(0b11100000 | get_bit_range(code_point, 12, 4));
+		push_byte(trailing_byte | get_bit_range(code_point, 6, 6));
+		push_byte(trailing_byte | get_bit_range(code_point, 0, 6));
+	}
+	else
+	{
+		push_byte(0b11110000 | get_bit_range(code_point, 18, 3));
+		push_byte(trailing_byte | get_bit_range(code_point, 12, 6));
+		push_byte(trailing_byte | get_bit_range(code_point, 6, 6));
+		push_byte(trailing_byte | get_bit_range(code_point, 0, 6));
+	}
+}
+} // namespace jsonish::detail
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef JSH_DETAIL_HASH_HPP_INCLUDED
+#define JSH_DETAIL_HASH_HPP_INCLUDED
+
+#include <cstdint>
+#include <string_view>
+
+namespace jsonish::detail
+{
+// The FNV-1a offset basis, used as the default seed.
+inline constexpr std::uint64_t default_hash_seed = 0xcbf29ce484222325u;
+
+/*
+ * Hash a key with 64-bit FNV-1a, starting from `seed`. Different seeds give
+ * unrelated hash functions, which is used to search for perfect hashes.
+ */
+[[nodiscard]] constexpr
+std::uint64_t hash_key(
+	std::string_view key, std::uint64_t seed = default_hash_seed) noexcept
+{
+	constexpr std::uint64_t prime = 0x100000001b3u;
+
+	auto hash = seed;
+	for (char c : key)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= prime;
+	}
+	return hash;
+}
+
+/*
+ * Scramble the bits of a hash so that every output bit depends on every input
+ * bit. This is the finalizer of SplitMix64.
+ */
+[[nodiscard]] constexpr
+std::uint64_t mix_hash(std::uint64_t hash) noexcept
+{
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9u;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebu;
+	hash ^= hash >> 31;
+	return hash;
+}
+} // namespace jsonish::detail
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef JSH_DIFF_HPP_INCLUDED
+#define JSH_DIFF_HPP_INCLUDED
+
+#include "jsonish/path.hpp"
+#include "jsonish/tree.hpp"
+
+#include <vector>
+
+namespace jsonish
+{
+/// What a `Change` does to the place at its path.
+enum struct ChangeKind
+{
+	added, ///< A member or element is inserted.
+	removed, ///< A member or element is removed.
+	changed ///< A value is replaced.
+};
+
+/// One difference between two values.
+struct Change
+{
+	ChangeKind kind;
+
+	/// Where the change is made. The root value has an empty path.
+	Path path;
+
+	/// The new value, if the change is not a removal.
+	Value value;
+};
+
+/// The differences between two values, in the order they are applied.
+using Patch = std::vector<Change>;
+
+/** Find the differences between two values.
+ *
+ * Objects are compared key by key, walking both sorted member lists
+ * together. Lists are compared index by index, with elements added to or
+ * removed from the end of the longer one, so an insertion near the start of
+ * a list changes every later element. A value of a different kind, or a
+ * different string, is replaced whole.
+ *
+ * Subtrees that `from` and `to` share, as after an edit of a `Document` or
+ * a copy of part of a tree, are skipped without being looked at, so the
+ * cost of comparing a value with an edited copy of it depends on the size of
+ * the edit rather than of the value.
+ *
+ * @return a patch that turns `from` into `to` when applied with `apply`
+ */
+[[nodiscard]]
+Patch diff(Value const& from, Value const& to);
+
+/** Apply a patch to a value.
+ *
+ * Changes are applied in order. An addition to a list inserts the value
+ * before the element at its index, which may be the size of the list. Only
+ * the containers along the paths of the changes are copied; everything else
+ * is shared with `value`.
+ *
+ * Throws `std::invalid_argument` if a path does not lead to a member or
+ * element of the right kind, or if an addition is made to an object at a
+ * key that is already present.
+ *
+ * @return `value` with the changes in `patch` made to it
+ */
+[[nodiscard]]
+Value apply(Patch const& patch, Value const& value);
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef JSH_DOCUMENT_HPP_INCLUDED
+#define JSH_DOCUMENT_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+namespace detail
+{
+/*
+ * Where a list or object is in the text of a `Document`, along with the
+ * lists and objects directly inside it, in the order they appear.
+ */
+struct Span
+{
+	// From the start of the enclosing span, or of the text for the root.
+	std::size_t offset = 0;
+
+	// Up to and including the closing bracket or brace.
+	std::size_t length = 0;
+
+	// Where the value is in the enclosing list or object.
+	std::size_t index = 0;
+	std::string key;
+
+	std::vector<Span> children;
+};
+} // namespace detail
+
+/** Text that is parsed again cheaply after each edit, as in an editor.
+ *
+ * A document remembers where each list and object is in its text. After an
+ * edit, only the innermost list or object containing the edit is parsed
+ * again and put in place of the old one. The lists and objects enclosing it
+ * are copied with the new value in place, and everything else is shared with
+ * the previous tree, so an edit costs time proportional to the size of the
+ * edited container and the width of the containers around it, rather than
+ * to the size of the document.
+ *
+ * If the edit leaves the innermost container unparsable on its own, for
+ * example by removing its closing bracket, enclosing containers are tried in
+ * turn, up to the whole document.
+ */
+class Document
+{
+public:
+	/** Parse a whole string into a document.
+	 *
+	 * @param text the text of the document
+	 * @param options controls how the text is parsed after every edit
+	 */
+	explicit
+	Document(std::string text, ParseOptions const& options = {});
+
+	/// Get the current text.
+	[[nodiscard]]
+	std::string_view text(void) const noexcept { return text_; }
+
+	/// Indicate whether the current text is valid.
+	[[nodiscard]]
+	bool is_valid(void) const noexcept { return errors_.empty(); }
+
+	/** Get the errors in the current text.
+	 *
+	 * The positions of the errors refer to the text at the time it was
+	 * parsed, so they should be used before the next edit.
+	 */
+	[[nodiscard]]
+	ErrorList const& errors(void) const noexcept { return errors_; }
+
+	/** Get the value of the text.
+	 *
+	 * If the text is not valid, this is the value of the last valid text,
+	 * or an empty string if there has been none.
+	 */
+	[[nodiscard]]
+	Value const& value(void) const noexcept { return value_; }
+
+	/** Replace characters of the text and parse it again.
+	 *
+	 * Throws `std::out_of_range` if the removed characters are not all in
+	 * the text.
+	 *
+	 * @param offset where the edit starts
+	 * @param removed the number of characters removed at `offset`
+	 * @param inserted the characters inserted at `offset`
+	 *
+	 * @return whether the edited text is valid
+	 */
+	bool edit(
+		std::size_t offset, std::size_t removed, std::string_view inserted);
+
+	/// Get the number of characters parsed again by the last edit.
+	[[nodiscard]]
+	std::size_t last_parsed_size(void) const noexcept
+	{
+		return last_parsed_size_;
+	}
+
+private:
+	// Parse the whole text again.
+	bool parse_all(void);
+
+	ParseOptions options_;
+
+	std::string text_;
+
+	Value value_;
+
+	// The span of the value, if it and the text are valid.
+	detail::Span span_;
+
+	ErrorList errors_;
+
+	std::size_t last_parsed_size_ = 0;
+};
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef JSH_INDEX_HPP_INCLUDED
+#define JSH_INDEX_HPP_INCLUDED
+
+#include "jsonish/path.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace jsonish
+{
+/** Finds elements of a list by the string at some path in each.
+ *
+ * For a list of records such as `[{"id" : "a", ...}, ...]`, an index on
+ * `"id"` finds a record in constant time instead of looking at each one.
+ * An index keeps the list alive by holding a copy of its value, which
+ * shares the list rather than copying it, so any number of indexes can be
+ * built over one list.
+ */
+class Index
+{
+public:
+	/** Index the elements of a list in a single pass.
+	 *
+	 * Elements without a string at `path` are left out. If several elements
+	 * have the same key, the first of them is found. Throws
+	 * `std::invalid_argument` if `list` is not a list.
+	 *
+	 * @param list the list to index
+	 * @param path leads from each element to its key
+	 * @param thread_count the most threads to use for reading keys,
+	 * including the calling thread, or 0 to use one per hardware thread
+	 */
+	Index(Value list, Path path, std::size_t thread_count = 1);
+
+	/// Index the elements of a list by the string with the given key.
+	Index(Value list, std::string key, std::size_t thread_count = 1) :
+		Index(std::move(list), Path{std::move(key)}, thread_count)
+	{}
+
+	/** Attempt to get the element with the given key.
+	 *
+	 * If no element has the key, produce an empty `MaybeValueReference`.
+	 */
+	[[nodiscard]]
+	auto find(std::string_view key) const noexcept -> MaybeValueReference;
+
+	/// Get the position in the list of the element with the given key.
+	[[nodiscard]]
+	std::optional<std::size_t> position(std::string_view key) const noexcept;
+
+	/// Get the number of distinct keys.
+	[[nodiscard]]
+	std::size_t size(void) const noexcept { return size_; }
+
+	/// Get the indexed list.
+	[[nodiscard]]
+	List const& list(void) const noexcept { return *list_; }
+
+	/// Get the path from each element to its key.
+	[[nodiscard]]
+	Path const& path(void) const noexcept { return path_; }
+
+private:
+	// Read the keys of the elements from `first` up to `last`.
+	void read_keys(std::size_t first, std::size_t last) noexcept;
+
+	Value value_;
+	List const* list_;
+	Path path_;
+
+	// The key of each element, which refers into the list.
+	std::vector<std::optional<std::string_view>> keys_;
+
+	// The hash of each element's key, in the same order as `keys_`.
+	std::vector<std::uint64_t> hashes_;
+
+	/*
+	 * A linearly probed hash table mapping slots to one more than the
+	 * position of an element, or to 0 for a free slot, as in `Object`.
+	 */
+	std::vector<std::uint32_t> slots_;
+
+	std::size_t size_ = 0;
+};
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef JSH_MERGE_HPP_INCLUDED
+#define JSH_MERGE_HPP_INCLUDED
+
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace jsonish
+{
+/** Combine layers of values, with later layers overriding earlier ones.
+ *
+ * Where every layer from some point on has an object, the objects are
+ * merged member by member, recursively. Anything else, including a list,
+ * replaces what the earlier layers have at the same place.
+ *
+ * Values that only one layer provides, or that no later layer overrides,
+ * are shared with that layer rather than copied, and a merged object whose
+ * members all come from one layer is that layer's object. The cost of a
+ * merge thus depends on how much the layers overlap rather than on their
+ * size.
+ *
+ * @param layers the values to combine, from the lowest to the highest
+ * @param count the number of layers, which must be at least one, or
+ * `std::invalid_argument` is thrown
+ *
+ * @return the combined value
+ */
+[[nodiscard]]
+Value merge(Value const* layers, std::size_t count);
+
+/// Combine every value in `layers`, as above.
+[[nodiscard]] inline
+Value merge(std::vector<Value> const& layers)
+{
+	return merge(layers.data(), layers.size());
+}
+
+/** Looks up values through layers without merging them first.
+ *
+ * An overlay holds the values found at one place in each layer, and the
+ * lookups below narrow it to a place further in. Each lookup costs time
+ * proportional to the number of layers, and only `value` merges anything,
+ * so reading a few settings from many large layers is cheap.
+ */
+class Overlay
+{
+public:
+	/// Create an overlay of the given layers, from the lowest to the highest.
+	explicit
+	Overlay(std::vector<Value> layers) noexcept : layers_(std::move(layers)) {}
+
+	/// Indicate whether any layer has a value at this place.
+	[[nodiscard]]
+	bool exists(void) const noexcept { return !layers_.empty(); }
+
+	/** Get the merged value at this place.
+	 *
+	 * If no layer has a value here, throw `std::bad_optional_access`.
+	 */
+	[[nodiscard]]
+	Value value(void) const;
+
+	/** Narrow the overlay to the values with the given key.
+	 *
+	 * If the merged value here would not be an object with the key, the
+	 * result does not exist.
+	 */
+	[[nodiscard]]
+	Overlay property(std::string_view key) const;
+
+	/** Narrow the overlay to the element with the given index.
+	 *
+	 * Lists are not merged, so this looks only in the list of the highest
+	 * layer, if it has one.
+	 */
+	[[nodiscard]]
+	Overlay at(std::size_t index) const;
+
+	/// Get the values at this place, from the lowest layer to the highest.
+	[[nodiscard]]
+	std::vector<Value> const& layers(void) const noexcept { return layers_; }
+
+private:
+	std::vector<Value> layers_;
+};
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef JSH_PADDED_STRING_HPP_INCLUDED
+#define JSH_PADDED_STRING_HPP_INCLUDED
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+namespace jsonish
+{
+/** A string followed by a block of zero bytes that may be read.
+ *
+ * Parsing a `PaddedString` lets the lexer scan whole words at a time without
+ * checking whether it has reached the end, since the padding stops any scan.
+ * The padding is not part of the string.
+ *
+ * A string that has been moved from is empty and has no characters or
+ * padding, so `data` produces a null pointer.
+ */
+class PaddedString
+{
+public:
+	/// The number of zero bytes after the end of the string.
+	static constexpr std::size_t padding = 32;
+
+	/// Construct an empty string.
+	PaddedString(void) : PaddedString(std::size_t{0}) {}
+
+	/** Construct a string of `size` zero bytes.
+	 *
+	 * The characters can then be written through `data`, for example by
+	 * reading a file directly into them.
+	 */
+	explicit
+	PaddedString(std::size_t size);
+
+	/// Construct a string holding a copy of `str`.
+	explicit
+	PaddedString(std::string_view str);
+
+	PaddedString(PaddedString const& other);
+	PaddedString(PaddedString&& other) noexcept;
+
+	PaddedString& operator=(PaddedString const& other);
+	PaddedString& operator=(PaddedString&& other) noexcept;
+
+	/// Get the characters, which may be changed but not the padding.
+	[[nodiscard]]
+	char* data(void) noexcept { return chars_.get(); }
+	[[nodiscard]]
+	char const* data(void) const noexcept { return chars_.get(); }
+
+	/// Get the number of characters, not including the padding.
+	[[nodiscard]]
+	std::size_t size(void) const noexcept { return size_; }
+
+	/// Get a view of the characters, not including the padding.
+	[[nodiscard]]
+	std::string_view view(void) const noexcept
+	{
+		return std::string_view(chars_.get(), size_);
+	}
+
+private:
+	std::unique_ptr<char[]> chars_;
+
+	std::size_t size_;
+};
+} // namespace jsonish
+
+#endif
@@ -1,25 +1,98 @@
 #ifndef JSH_PARSE_HPP_INCLUDED
 #define JSH_PARSE_HPP_INCLUDED
 
+#include "jsonish/cancellation.hpp"
+#include "jsonish/padded_string.hpp"
+#include "jsonish/parse_options.hpp"
 #include "jsonish/result.hpp"
 
 #include "jsonish/tree.hpp"
 
+#include <memory>
 #include <string_view>
 
 namespace jsonish
 {
+struct ParseScratch;
+
 /** Parses a whole string as jsonish.
  *
  * The entire string must be valid. Whitespace is allowed at the end.
  *
  * @param str the string to parse
+ * @param options controls how `str` is parsed
  *
  * @return an invalid result if `str` could not be parsed, or a valid
  * `jsonish::Value` otherwise
  */
 [[nodiscard]]
-Result<Value> parse(std::string_view str);
+Result<Value> parse(std::string_view str, ParseOptions const& options = {});
+
+/** Parses a whole padded string as jsonish.
+ *
+ * This behaves like `parse(str.view(), options)`, but relies on the padding
+ * to skip checking for the end of the input on every character.
+ */
+[[nodiscard]]
+Result<Value> parse(PaddedString const& str, ParseOptions const& options = {});
+
+/** Parses strings as jsonish, keeping its buffers from one parse to the next.
+ *
+ * The free `parse` functions start with empty buffers each time. A parser
+ * instead keeps the stacks on which it collects the items of open containers,
+ * so once it has seen documents of some size, parsing more of them allocates
+ * only the resulting tree: one block per container and per string too long
+ * to be stored inline. A parser is meant to be kept per thread and must not
+ * be used by several threads at once.
+ *
+ * A parser that has been moved from keeps its options and can still be
+ * used, starting again with empty buffers.
+ */
+class Parser
+{
+public:
+	/// Construct a parser that parses with the given options.
+	explicit
+	Parser(ParseOptions const& options = {});
+
+	Parser(Parser&&) noexcept;
+	Parser& operator=(Parser&&) noexcept;
+
+	~Parser(void);
+
+	/// Parse a whole string, like the free `parse`.
+	[[nodiscard]]
+	Result<Value> parse(std::string_view str);
+
+	/// Parse a whole padded string, like the free `parse`.
+	[[nodiscard]]
+	Result<Value> parse(PaddedString const& str);
+
+	/** Parse a whole string, stopping early if `cancellation` is cancelled.
+	 *
+	 * If the parse is cancelled, the result holds a single
+	 * `ErrorCode::cancelled` error at the container that was about to be
+	 * read.
+	 */
+	[[nodiscard]]
+	Result<Value> parse(
+		std::string_view str, CancellationToken const& cancellation);
+	[[nodiscard]]
+	Result<Value> parse(
+		PaddedString const& str, CancellationToken const& cancellation);
+
+	/// Free the buffers kept from earlier parses.
+	void release_memory(void);
+
+	/// Get the options this parser was constructed with.
+	[[nodiscard]]
+	ParseOptions const& options(void) const noexcept { return options_; }
+
+private:
+	ParseOptions options_;
+
+	std::unique_ptr<ParseScratch> scratch_;
+};
 } // namespace jsonish
 
 #endif
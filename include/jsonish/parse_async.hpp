@@ -0,0 +1,164 @@
+#ifndef JSH_PARSE_ASYNC_HPP_INCLUDED
+#define JSH_PARSE_ASYNC_HPP_INCLUDED
+
+#include "jsonish/cancellation.hpp"
+#include "jsonish/parse.hpp"
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <exception>
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define JSONISH_HAS_COROUTINES 1
+#endif
+
+namespace jsonish
+{
+/** Runs tasks, for example on a thread pool or an event loop.
+ *
+ * An executor must run each task it is given exactly once. It may run the
+ * task before returning.
+ */
+using Executor = std::function<void(std::function<void()>)>;
+
+/// An executor that runs each task on a new, detached thread.
+void run_on_new_thread(std::function<void()> task);
+
+namespace detail
+{
+/*
+ * Parse a document that is freed once parsing is done, so the positions of
+ * errors keep only their offsets.
+ */
+[[nodiscard]]
+Result<Value> parse_owned(
+	std::string const& document,
+	ParseOptions const& options,
+	CancellationToken const& cancellation);
+} // namespace detail
+
+/** Parse a document on an executor.
+ *
+ * The document is parsed as by `parse`, using a `Parser` created for the
+ * task. If parsing throws, the exception is stored in the future.
+ *
+ * The document is freed once it is parsed, so the positions of errors have
+ * only offsets, and their messages give the offset rather than the line and
+ * column.
+ *
+ * @param document the document to parse, which the task takes ownership of
+ * @param executor runs the parse
+ * @param options controls how `document` is parsed
+ * @param cancellation stops the parse at the next container once cancelled
+ *
+ * @return a future that becomes ready once the parse finishes
+ */
+[[nodiscard]]
+std::future<Result<Value>> parse_async(
+	std::string document,
+	Executor const& executor,
+	ParseOptions const& options = {},
+	CancellationToken const& cancellation = {});
+
+/// Parse a document on a new thread, as above.
+[[nodiscard]]
+std::future<Result<Value>> parse_async(
+	std::string document,
+	ParseOptions const& options = {},
+	CancellationToken const& cancellation = {});
+
+#ifdef JSONISH_HAS_COROUTINES
+/** Parses a document on an executor when awaited in a coroutine.
+ *
+ * The awaiting coroutine is suspended and resumed by the executor once the
+ * parse finishes, on whichever thread ran it. `co_await` produces the result
+ * of the parse, or rethrows an exception thrown while parsing. As with
+ * `parse_async`, errors have only offsets.
+ */
+class ParseAwaitable
+{
+public:
+	ParseAwaitable(
+		std::string document,
+		Executor executor,
+		ParseOptions const& options,
+		CancellationToken cancellation) :
+		document_(std::move(document)),
+		executor_(std::move(executor)),
+		options_(options),
+		cancellation_(std::move(cancellation))
+	{}
+
+	[[nodiscard]]
+	bool await_ready(void) const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> awaiting)
+	{
+		/*
+		 * Resuming the coroutine may destroy this awaitable, even before
+		 * the executor returns, so the executor must not be a member then.
+		 */
+		auto executor = std::move(executor_);
+		executor([this, awaiting]()
+		{
+			try
+			{
+				result_.emplace(
+					detail::parse_owned(document_, options_, cancellation_));
+			}
+			catch (...)
+			{
+				error_ = std::current_exception();
+			}
+			awaiting.resume();
+		});
+	}
+
+	Result<Value> await_resume(void)
+	{
+		if (error_)
+		{
+			std::rethrow_exception(error_);
+		}
+		return *std::move(result_);
+	}
+
+private:
+	std::string document_;
+
+	Executor executor_;
+
+	ParseOptions options_;
+
+	CancellationToken cancellation_;
+
+	std::optional<Result<Value>> result_;
+
+	std::exception_ptr error_;
+};
+
+/// Create an awaitable that parses `document` on `executor`.
+[[nodiscard]] inline
+ParseAwaitable parse_awaitable(
+	std::string document,
+	Executor executor = run_on_new_thread,
+	ParseOptions const& options = {},
+	CancellationToken cancellation = {})
+{
+	return ParseAwaitable(
+		std::move(document),
+		std::move(executor),
+		options,
+		std::move(cancellation));
+}
+#endif
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef JSH_PARSE_INTO_HPP_INCLUDED
+#define JSH_PARSE_INTO_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/source_position.hpp"
+#include "jsonish/tree.hpp"
+
+#include <array>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jsonish
+{
+class Lexer;
+struct ParseScratch;
+
+/// The outcome of asking a `TokenReader` for the next item in a container.
+enum struct ReadStatus
+{
+	item, ///< Another member or element follows.
+	end, ///< The container was closed.
+	error ///< The input was invalid.
+};
+
+/** Reads jsonish values directly from a sequence of characters.
+ *
+ * This is the building block for `parse_into`. Each member function consumes
+ * tokens and reports failure by recording errors, which can be obtained with
+ * `errors`. Once a member function has failed, the reader should not be used
+ * for anything but getting its errors.
+ *
+ * Lists and objects are counted against the `max_depth` limit, whether they
+ * are read or skipped, and values read with `read_value` are counted against
+ * the limits on the tree as if they were one document. The reader does not
+ * check `max_input_bytes`, which `parse_into` does.
+ */
+class TokenReader
+{
+public:
+	/** Construct a reader over a sequence of characters.
+	 *
+	 * @param chars the sequence of input characters
+	 * @param options controls how strings are checked
+	 */
+	explicit
+	TokenReader(std::string_view chars, ParseOptions const& options = {});
+
+	TokenReader(TokenReader&&) noexcept;
+	TokenReader& operator=(TokenReader&&) noexcept;
+
+	~TokenReader(void);
+
+	/// Read a string into `out`.
+	bool read_string(std::string& out);
+
+	/// Read a whole value into `out`, building a tree.
+	bool read_value(Value& out);
+
+	/// Read and validate a value without storing it.
+	bool skip_value(void);
+
+	/// Read the '{' starting an object.
+	bool begin_object(void);
+
+	/** Read the next key of the innermost object and the ':' following it.
+	 *
+	 * If the object is closed instead, its '}' is read and
+	 * `ReadStatus::end` is produced.
+	 */
+	ReadStatus next_member(std::string& key);
+
+	/// Read the '[' starting a list.
+	bool begin_list(void);
+
+	/** Prepare to read the next element of the innermost list.
+	 *
+	 * If the list is closed instead, its ']' is read and `ReadStatus::end`
+	 * is produced.
+	 */
+	ReadStatus next_element(void);
+
+	/// Ensure that nothing but whitespace remains.
+	bool finish(void);
+
+	/** Record an error.
+	 *
+	 * The error is placed at the most recent key or closing brace read by
+	 * `next_member`, or at the next token if there is none.
+	 */
+	void fail(ErrorCode code);
+
+	/// Get the errors recorded so far.
+	[[nodiscard]]
+	ErrorList const& errors(void) const& noexcept { return errors_; }
+	[[nodiscard]]
+	ErrorList&& errors(void) && noexcept { return std::move(errors_); }
+
+private:
+	std::unique_ptr<Lexer> lex_;
+
+	// Shared by each value read or skipped.
+	std::unique_ptr<ParseScratch> scratch_;
+
+	/*
+	 * For each open container, whether its first item has yet to be read.
+	 * This determines whether a ',' is expected before the next item.
+	 */
+	std::vector<bool> at_first_item_;
+
+	// Where `fail` places errors, if set.
+	std::optional<SourcePosition> last_position_;
+
+	ErrorList errors_;
+};
+
+/** Describes the members of a struct for `parse_into`.
+ *
+ * Specialize this for a struct with a `static constexpr` data member named
+ * `members` holding a tuple of `jsonish::Member`s, most easily created with
+ * `JSONISH_DESCRIBE`.
+ */
+template <typename T>
+struct Describe;
+
+/// Associates a key with a data member of `Class`.
+template <typename Class, typename Type>
+struct Member
+{
+	std::string_view key;
+	Type Class::* pointer;
+};
+
+/// Create a `Member` associating `key` with the data member `pointer`.
+template <typename Class, typename Type>
+[[nodiscard]] constexpr
+auto member(std::string_view key, Type Class::* pointer) noexcept
+	-> Member<Class, Type>
+{
+	return Member<Class, Type>{key, pointer};
+}
+
+/** Reads a value of type `T` from a `TokenReader`.
+ *
+ * Specializations exist for `std::string`, `jsonish::Value`,
+ * `std::vector`, `std::map` with string keys, and any type with a
+ * `Describe` specialization. It can be specialized for other types.
+ */
+template <typename T, typename = void>
+struct Deserialize
+{
+	static_assert(
+		sizeof(T) == 0,
+		"type has no jsonish::Describe or jsonish::Deserialize "
+		"specialization");
+};
+
+template <>
+struct Deserialize<std::string>
+{
+	static bool read(TokenReader& reader, std::string& out)
+	{
+		return reader.read_string(out);
+	}
+};
+
+template <>
+struct Deserialize<Value>
+{
+	static bool read(TokenReader& reader, Value& out)
+	{
+		return reader.read_value(out);
+	}
+};
+
+template <typename T>
+struct Deserialize<std::vector<T>>
+{
+	static bool read(TokenReader& reader, std::vector<T>& out)
+	{
+		if (!reader.begin_list())
+		{
+			return false;
+		}
+
+		while (true)
+		{
+			auto const status = reader.next_element();
+			if (status != ReadStatus::item)
+			{
+				return status == ReadStatus::end;
+			}
+			if (!Deserialize<T>::read(reader, out.emplace_back()))
+			{
+				return false;
+			}
+		}
+	}
+};
+
+template <typename T, typename Compare, typename Allocator>
+struct Deserialize<std::map<std::string, T, Compare, Allocator>>
+{
+	static bool read(
+		TokenReader& reader,
+		std::map<std::string, T, Compare, Allocator>& out)
+	{
+		if (!reader.begin_object())
+		{
+			return false;
+		}
+
+		std::string key;
+		while (true)
+		{
+			auto const status = reader.next_member(key);
+			if (status != ReadStatus::item)
+			{
+				return status == ReadStatus::end;
+			}
+
+			auto [pos, inserted] = out.try_emplace(std::move(key));
+			if (!inserted)
+			{
+				reader.fail(ErrorCode::duplicate_key);
+				return false;
+			}
+			if (!Deserialize<T>::read(reader, pos->second))
+			{
+				return false;
+			}
+		}
+	}
+};
+
+// Reads a struct described by a `Describe` specialization.
+template <typename T>
+struct Deserialize<T, std::void_t<decltype(Describe<T>::members)>>
+{
+	static bool read(TokenReader& reader, T& out)
+	{
+		if (!reader.begin_object())
+		{
+			return false;
+		}
+
+		std::array<bool, member_count> seen{};
+		std::string key;
+		while (true)
+		{
+			auto const status = reader.next_member(key);
+			if (status == ReadStatus::error)
+			{
+				return false;
+			}
+			if (status == ReadStatus::end)
+			{
+				break;
+			}
+
+			auto const found = read_member(
+				reader, out, key, seen,
+				std::make_index_sequence<member_count>{});
+			if (found == Found::failed)
+			{
+				return false;
+			}
+			if (found == Found::no_match && !reader.skip_value())
+			{
+				return false;
+			}
+		}
+
+		if (!has_required_members(
+			seen, std::make_index_sequence<member_count>{}))
+		{
+			reader.fail(ErrorCode::missing_member);
+			return false;
+		}
+		return true;
+	}
+
+private:
+	static constexpr auto member_count =
+		std::tuple_size_v<std::decay_t<decltype(Describe<T>::members)>>;
+
+	template <std::size_t I>
+	using MemberType = std::decay_t<decltype(
+		std::declval<T&>().*(std::get<I>(Describe<T>::members).pointer))>;
+
+	template <typename U>
+	struct IsOptional : std::false_type {};
+	template <typename U>
+	struct IsOptional<std::optional<U>> : std::true_type {};
+
+	// The outcome of looking for and reading a member with some key.
+	enum struct Found
+	{
+		read,
+		failed,
+		no_match
+	};
+
+	template <std::size_t I>
+	static constexpr
+	auto& out_member(T& out) noexcept
+	{
+		return out.*(std::get<I>(Describe<T>::members).pointer);
+	}
+
+	// Read into a member, emplacing it first if it is optional.
+	template <typename U>
+	static bool read_into(TokenReader& reader, U& out)
+	{
+		return Deserialize<U>::read(reader, out);
+	}
+	template <typename U>
+	static bool read_into(TokenReader& reader, std::optional<U>& out)
+	{
+		return Deserialize<U>::read(reader, out.emplace());
+	}
+
+	/*
+	 * Read the value of the member whose key is `key`. The comparisons are
+	 * unrolled at compile time against the keys in `Describe<T>`.
+	 */
+	template <std::size_t... I>
+	static Found read_member(
+		TokenReader& reader,
+		T& out,
+		std::string_view key,
+		std::array<bool, member_count>& seen,
+		std::index_sequence<I...>)
+	{
+		auto found = Found::no_match;
+		(void)((key == std::get<I>(Describe<T>::members).key
+			&& (found = read_nth_member<I>(reader, out, seen), true))
+			|| ...);
+		return found;
+	}
+
+	template <std::size_t I>
+	static Found read_nth_member(
+		TokenReader& reader, T& out, std::array<bool, member_count>& seen)
+	{
+		if (seen[I])
+		{
+			reader.fail(ErrorCode::duplicate_key);
+			return Found::failed;
+		}
+		seen[I] = true;
+		return read_into(reader, out_member<I>(out))
+			? Found::read
+			: Found::failed;
+	}
+
+	// Check that every member that is not a `std::optional` was read.
+	template <std::size_t... I>
+	static constexpr
+	bool has_required_members(
+		std::array<bool, member_count> const& seen,
+		std::index_sequence<I...>) noexcept
+	{
+		return ((seen[I] || IsOptional<MemberType<I>>::value) && ...);
+	}
+};
+
+/** Parse a whole string directly into a value of type `T`.
+ *
+ * `T` must be default constructible and readable by `Deserialize<T>`. No
+ * `jsonish::Value` is built, except for members that are themselves of type
+ * `jsonish::Value`.
+ *
+ * For a described struct, keys without a matching member are validated and
+ * skipped, repeated keys are an error, and every member that is not a
+ * `std::optional` must be present.
+ *
+ * @param str the string to parse
+ * @param options controls how `str` is parsed
+ *
+ * @return an invalid result if `str` could not be parsed, or a valid `T`
+ * otherwise
+ */
+template <typename T>
+[[nodiscard]]
+Result<T> parse_into(std::string_view str, ParseOptions const& options = {})
+{
+	auto const max_input_bytes = options.limits.max_input_bytes;
+	if (str.size() > max_input_bytes)
+	{
+		return Result<T>(ErrorList{Error{
+			ErrorCode::input_too_large, SourcePosition{str, max_input_bytes}}});
+	}
+
+	TokenReader reader(str, options);
+
+	T value{};
+	if (!Deserialize<T>::read(reader, value) || !reader.finish())
+	{
+		return Result<T>(std::move(reader).errors());
+	}
+	return Result<T>(std::move(value));
+}
+} // namespace jsonish
+
+/// Create a `jsonish::Member` for the data member `name` of `Type`.
+#define JSONISH_MEMBER(Type, name) ::jsonish::member(#name, &Type::name)
+
+/** Specialize `jsonish::Describe` for `Type` with the given members.
+ *
+ * This must be used at global scope. Each argument after `Type` should be a
+ * `jsonish::Member`, for example created with `JSONISH_MEMBER`.
+ */
+#define JSONISH_DESCRIBE(Type, ...) \
+	template <> \
+	struct jsonish::Describe<Type> \
+	{ \
+		static constexpr auto members = std::make_tuple(__VA_ARGS__); \
+	}
+
+#endif
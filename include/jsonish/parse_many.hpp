@@ -0,0 +1,52 @@
+#ifndef JSH_PARSE_MANY_HPP_INCLUDED
+#define JSH_PARSE_MANY_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+/** Parses many independent documents using several threads.
+ *
+ * Each document is parsed as by `parse`. Threads take the largest remaining
+ * document each time they finish one, so a few large documents are started
+ * early rather than left running alone at the end. Each thread parses with
+ * its own `Parser`, so threads share nothing but the index of the next
+ * document.
+ *
+ * If parsing throws, the exception is rethrown once every thread has
+ * stopped.
+ *
+ * @param documents the documents to parse, which are not copied
+ * @param count the number of documents
+ * @param options controls how the documents are parsed
+ * @param thread_count the most threads to use, including the calling thread,
+ * or 0 to use one per hardware thread
+ *
+ * @return the result of parsing each document, in the order of `documents`
+ */
+[[nodiscard]]
+std::vector<Result<Value>> parse_many(
+	std::string_view const* documents,
+	std::size_t count,
+	ParseOptions const& options = {},
+	std::size_t thread_count = 0);
+
+/// Parse every document in `documents`, as above.
+[[nodiscard]] inline
+std::vector<Result<Value>> parse_many(
+	std::vector<std::string_view> const& documents,
+	ParseOptions const& options = {},
+	std::size_t thread_count = 0)
+{
+	return parse_many(
+		documents.data(), documents.size(), options, thread_count);
+}
+} // namespace jsonish
+
+#endif
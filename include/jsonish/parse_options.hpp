@@ -0,0 +1,81 @@
+#ifndef JSH_PARSE_OPTIONS_HPP_INCLUDED
+#define JSH_PARSE_OPTIONS_HPP_INCLUDED
+
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <limits>
+
+namespace jsonish
+{
+/// A limit that is never reached.
+inline constexpr std::size_t no_limit = std::numeric_limits<std::size_t>::max();
+
+/** Bounds on what parsing a document may use, for input that is not trusted.
+ *
+ * Each limit is checked as the input is read, at the point it would be
+ * exceeded, so an abusive document stops being parsed there, and the result
+ * holds an error with the code for that limit. Nothing is limited by
+ * default.
+ *
+ * `parse`, `Parser`, `parse_async`, `parse_many`, `Document`, and parsing
+ * with a `Schema` check every limit. So does parsing input read from a
+ * `Source`, where the input size and string lengths are checked as
+ * characters arrive, before the whole input or a whole string is held.
+ * Other entry points check fewer: `parse_into` checks `max_input_bytes`,
+ * `max_depth`, and `max_string_length`, and the limits on the tree only
+ * for what it reads into a `jsonish::Value`. `PullReader` checks only
+ * `max_input_bytes` and `max_string_length`, and `Tokenizer` checks none.
+ *
+ * Values that a `Projection` skips are not stored, so of the limits below
+ * only `max_input_bytes` and `max_depth` apply to them.
+ */
+struct ParseLimits
+{
+	/// The most characters of input, including whitespace.
+	std::size_t max_input_bytes = no_limit;
+
+	/// The most lists and objects inside one another, counting the root.
+	std::size_t max_depth = no_limit;
+
+	/** The most bytes in one string or key, once decoded.
+	 *
+	 * Decoding stops once a string passes the limit, so a longer string is
+	 * rejected without being copied whole.
+	 */
+	std::size_t max_string_length = no_limit;
+
+	/// The most values in the document, counting strings and containers.
+	std::size_t max_nodes = no_limit;
+
+	/// The most members in one object.
+	std::size_t max_members = no_limit;
+
+	/** The most bytes the tree may allocate.
+	 *
+	 * This is estimated from the nodes, items, and long strings and keys
+	 * of the tree as it is built, without counting any sharing.
+	 */
+	std::size_t max_allocated_bytes = no_limit;
+};
+
+/// Controls how input is parsed.
+struct ParseOptions
+{
+	/** Reject strings that are not valid UTF-8.
+	 *
+	 * When set, raw characters in strings must form valid UTF-8 and '\\u'
+	 * escapes may not produce lone surrogates. Validation happens while
+	 * strings are scanned, so no separate pass over the input is needed.
+	 */
+	bool validate_utf8 = false;
+
+	/// How parsed objects find their members.
+	ObjectStorage object_storage = ObjectStorage::automatic;
+
+	/// Bounds on what parsing may use.
+	ParseLimits limits;
+};
+} // namespace jsonish
+
+#endif
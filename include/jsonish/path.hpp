@@ -0,0 +1,44 @@
+#ifndef JSH_PATH_HPP_INCLUDED
+#define JSH_PATH_HPP_INCLUDED
+
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace jsonish
+{
+/// A key in an object or an index in a list.
+using PathElement = std::variant<std::string, std::size_t>;
+
+/// The keys and indices leading from a value to one inside it.
+using Path = std::vector<PathElement>;
+
+/** Attempt to get the value at a path inside `value`.
+ *
+ * If some key or index along the path does not exist, produce an empty
+ * `MaybeValueReference`. An empty path leads to `value` itself.
+ */
+[[nodiscard]] inline
+auto find_path(Value const& value, Path const& path) noexcept
+	-> MaybeValueReference
+{
+	auto found = MaybeValueReference::value(value);
+	for (auto const& element : path)
+	{
+		if (!found.exists())
+		{
+			break;
+		}
+		auto const* key = std::get_if<std::string>(&element);
+		found = key
+			? found.as_value().property(*key)
+			: found.as_value().at(*std::get_if<std::size_t>(&element));
+	}
+	return found;
+}
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef JSH_PROJECTION_HPP_INCLUDED
+#define JSH_PROJECTION_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/path.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace jsonish
+{
+/// How a `Projection` selects a member or element.
+enum struct Selection
+{
+	skip, ///< Check the value, but leave it out.
+	descend, ///< Build the container, selecting each item, or the string.
+	keep ///< Build the whole value.
+};
+
+/** Selects which parts of a document to build while parsing it.
+ *
+ * A projection is asked about each member and element of the containers
+ * it descends into, given the path to it from the root. The root itself is
+ * always built, and its items are asked about.
+ */
+class Projection
+{
+public:
+	/** Select whole values at the given paths.
+	 *
+	 * The containers leading to the paths are built with only the items
+	 * on the way to them, and everything else is skipped.
+	 */
+	explicit
+	Projection(std::vector<Path> paths);
+
+	/// Select values with a function of their path.
+	template <
+		typename Select,
+		typename = std::enable_if_t<
+			std::is_invocable_r_v<Selection, Select const&, Path const&>>>
+	explicit
+	Projection(Select select) : select_(std::move(select))
+	{}
+
+	/// Decide how to parse the member or element at `path`.
+	[[nodiscard]]
+	Selection select(Path const& path) const { return select_(path); }
+
+private:
+	std::function<Selection(Path const&)> select_;
+};
+
+/** Parse a whole string, building only the parts `projection` selects.
+ *
+ * Skipped values are checked as thoroughly as by `parse`, so the same
+ * strings are accepted, but their strings are scanned without being decoded
+ * and nothing is allocated for them. The only exception is that a key
+ * repeated inside a skipped object is not noticed; keys repeated in an
+ * object that is built are, even if the members with them are skipped.
+ *
+ * Objects keep only the selected members, and lists only the selected
+ * elements, in their original order. Paths given to the projection use
+ * the indices of elements in the input.
+ *
+ * @param str the string to parse
+ * @param projection selects the parts to build
+ * @param options controls how `str` is parsed
+ *
+ * @return an invalid result if `str` could not be parsed, or a valid
+ * `jsonish::Value` with the selected parts otherwise
+ */
+[[nodiscard]]
+Result<Value> parse(
+	std::string_view str,
+	Projection const& projection,
+	ParseOptions const& options = {});
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef JSH_PULL_READER_HPP_INCLUDED
+#define JSH_PULL_READER_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tokenizer.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace jsonish
+{
+/// Supplies the characters read by a `PullReader`, a piece at a time.
+class Source
+{
+public:
+	virtual ~Source(void) = default;
+
+	/** Read up to `size` characters into `buffer`.
+	 *
+	 * This may read fewer characters than asked for, but must read at
+	 * least one unless the input is exhausted. Failures should be reported
+	 * by throwing.
+	 *
+	 * @return the number of characters read, which is 0 only at the end of
+	 * the input
+	 */
+	virtual std::size_t read(char* buffer, std::size_t size) = 0;
+};
+
+/** Reads from a file descriptor, such as a pipe or socket.
+ *
+ * The descriptor is not closed. Failing to read throws `std::system_error`.
+ */
+class FdSource : public Source
+{
+public:
+	explicit
+	FdSource(int fd) noexcept : fd_(fd) {}
+
+	std::size_t read(char* buffer, std::size_t size) override;
+
+private:
+	int fd_;
+};
+
+/** Reads from a `std::istream`.
+ *
+ * The stream must outlive the source. If the stream goes bad,
+ * `std::ios_base::failure` is thrown.
+ */
+class StreamSource : public Source
+{
+public:
+	explicit
+	StreamSource(std::istream& stream) noexcept : stream_(&stream) {}
+
+	std::size_t read(char* buffer, std::size_t size) override;
+
+private:
+	std::istream* stream_;
+};
+
+/** Reads tokens from a `Source`, holding only a fixed amount of its input.
+ *
+ * Characters are read into a buffer of a fixed size as tokens need them.
+ * A string that does not fit in the buffer is gathered in a separate buffer
+ * as it is read, so only strings, not the input as a whole, need to fit in
+ * memory.
+ *
+ * Errors hold the offset of the failing token in the input. Since the input
+ * is not kept, their positions have no characters to count lines in, and
+ * their messages give the offset instead.
+ *
+ * The `max_input_bytes` and `max_string_length` limits of the options are
+ * checked as characters are read, so a string is rejected before more than
+ * a few times its limit is gathered.
+ */
+class PullReader
+{
+public:
+	/// The default size of the buffer characters are read into.
+	static constexpr std::size_t default_buffer_size = 64 * 1024;
+
+	/** Construct a reader over a source, which must outlive it.
+	 *
+	 * @param source supplies the input
+	 * @param options controls how strings are checked, and limits the input
+	 * @param buffer_size the number of characters read at a time, at
+	 * least 1
+	 */
+	explicit
+	PullReader(
+		Source& source,
+		ParseOptions const& options = {},
+		std::size_t buffer_size = default_buffer_size);
+
+	/** Read the next token.
+	 *
+	 * This invalidates the text of the previous token.
+	 *
+	 * @return `true` if a token was read, or `false` at the end of the
+	 * input or if the next token is invalid, as told by `error`
+	 */
+	bool next(void);
+
+	/// Get the kind of the current token.
+	[[nodiscard]]
+	TokenKind kind(void) const noexcept { return kind_; }
+
+	/** Get the decoded text of the current token, if it is a string.
+	 *
+	 * The view is valid until the next call to `next`.
+	 */
+	[[nodiscard]]
+	std::string_view text(void) const noexcept { return text_; }
+
+	/** Get the offset in the input of the current token.
+	 *
+	 * After `next` fails, this is the offset of the invalid token or of the
+	 * end of the input.
+	 */
+	[[nodiscard]]
+	std::size_t offset(void) const noexcept { return offset_; }
+
+	/// Get the error that stopped `next`, if any.
+	[[nodiscard]]
+	std::optional<Error> const& error(void) const noexcept { return error_; }
+
+	/// Get the options this reader was constructed with.
+	[[nodiscard]]
+	ParseOptions const& options(void) const noexcept { return options_; }
+
+private:
+	/*
+	 * Read more characters after those in the buffer, keeping those from
+	 * `pos_` on. Produce `false` at the end of the input.
+	 */
+	bool fill(void);
+
+	// Read a string after its opening quote.
+	bool read_string(void);
+
+	bool fail(ErrorCode code, std::size_t offset);
+
+	Source* source_;
+
+	ParseOptions options_;
+
+	std::unique_ptr<char[]> buffer_;
+	std::size_t capacity_;
+
+	// The characters yet to be read are those from `pos_` to `end_`.
+	std::size_t pos_ = 0;
+	std::size_t end_ = 0;
+
+	// The offset in the input of the start of the buffer.
+	std::size_t base_ = 0;
+
+	bool exhausted_ = false;
+
+	TokenKind kind_ = TokenKind::string;
+	std::string_view text_;
+	std::size_t offset_ = 0;
+
+	// A string too long for the buffer, and decoded text.
+	std::string gathered_;
+	std::string decoded_;
+
+	std::optional<Error> error_;
+};
+
+/** Parse the whole input of a source as jsonish.
+ *
+ * This parses the tokens of a `PullReader` with the same parser as the other
+ * `parse` functions, so it accepts the same input and applies the same
+ * options, while holding only a fixed amount of the input at a time. If a
+ * token is invalid, the result holds the error the token was expected to
+ * satisfy, followed by the reason the token is invalid.
+ *
+ * The tree is still built in memory, and nesting is parsed recursively, so
+ * input that is not trusted should be read with `ParseLimits` such as
+ * `max_depth` and `max_allocated_bytes` set.
+ *
+ * @param source supplies the input
+ * @param options controls how the input is parsed
+ * @param buffer_size the number of characters read at a time
+ */
+[[nodiscard]]
+Result<Value> parse(
+	Source& source,
+	ParseOptions const& options = {},
+	std::size_t buffer_size = PullReader::default_buffer_size);
+} // namespace jsonish
+
+#endif
@@ -4,6 +4,8 @@
 #include "jsonish/source_position.hpp"
 
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
@@ -11,12 +13,105 @@
 
 namespace jsonish
 {
-/// An error encountered during the compilation process
+/// Identifies the kind of an `Error`.
+enum struct ErrorCode
+{
+	unexpected_character, ///< A character that cannot start a token.
+	no_closing_quote, ///< A string is missing its closing '"'.
+	expected_hex_digit, ///< A '\\u' escape has a non-hex digit.
+	invalid_escape_sequence, ///< A backslash is followed by a bad char.
+	invalid_character_in_string, ///< A control character is in a string.
+	invalid_utf8, ///< A string contains an invalid UTF-8 sequence.
+	unpaired_surrogate, ///< A '\\u' escape is an unpaired surrogate.
+
+	expected_lbracket, ///< Expected '['.
+	expected_rbracket, ///< Expected ']'.
+	expected_lbrace, ///< Expected '{'.
+	expected_rbrace, ///< Expected '}'.
+	expected_colon, ///< Expected ':'.
+	expected_key, ///< Expected a string as an object key.
+	expected_value, ///< Expected a string, '{', or '['.
+	duplicate_key, ///< A key appears more than once in an object.
+	expected_string, ///< Expected a string.
+	missing_member, ///< A required member of a struct is missing.
+	unknown_key, ///< A key that is not part of a schema.
+	wrong_kind, ///< A value does not have the kind required by a schema.
+	trailing_characters, ///< Non-whitespace follows the top-level value.
+	cancelled, ///< Parsing was stopped through a `CancellationToken`.
+
+	input_too_large, ///< The input is longer than its limit.
+	too_deep, ///< Containers are nested deeper than their limit.
+	string_too_long, ///< A string is longer than its limit.
+	too_many_nodes, ///< The document has more values than its limit.
+	too_many_members, ///< An object has more members than its limit.
+	too_much_memory ///< The tree would take more memory than its limit.
+};
+
+/** Get a short description of an error code.
+ *
+ * The returned view refers to static storage.
+ */
+[[nodiscard]] constexpr
+std::string_view describe(ErrorCode code) noexcept
+{
+	switch (code)
+	{
+	case ErrorCode::unexpected_character: return "unexpected character";
+	case ErrorCode::no_closing_quote: return "no closing quote";
+	case ErrorCode::expected_hex_digit: return "expected a hex digit";
+	case ErrorCode::invalid_escape_sequence:
+		return "invalid escape sequence";
+	case ErrorCode::invalid_character_in_string:
+		return "invalid character in string";
+	case ErrorCode::invalid_utf8: return "invalid utf-8 in string";
+	case ErrorCode::unpaired_surrogate: return "unpaired surrogate";
+	case ErrorCode::expected_lbracket: return "expected '['";
+	case ErrorCode::expected_rbracket: return "expected ']'";
+	case ErrorCode::expected_lbrace: return "expected '{'";
+	case ErrorCode::expected_rbrace: return "expected '}'";
+	case ErrorCode::expected_colon: return "expected ':'";
+	case ErrorCode::expected_key: return "expected string as key";
+	case ErrorCode::expected_value: return "expected string, '{', or '['";
+	case ErrorCode::duplicate_key: return "key already defined";
+	case ErrorCode::expected_string: return "expected string";
+	case ErrorCode::missing_member: return "missing required member";
+	case ErrorCode::unknown_key: return "key not in schema";
+	case ErrorCode::wrong_kind: return "value has the wrong kind";
+	case ErrorCode::trailing_characters: return "garbage at end of input";
+	case ErrorCode::cancelled: return "parsing was cancelled";
+	case ErrorCode::input_too_large: return "input is too large";
+	case ErrorCode::too_deep: return "containers are nested too deeply";
+	case ErrorCode::string_too_long: return "string is too long";
+	case ErrorCode::too_many_nodes: return "too many values";
+	case ErrorCode::too_many_members: return "object has too many members";
+	case ErrorCode::too_much_memory: return "value would use too much memory";
+	default: return "unknown error";
+	}
+}
+
+/** An error encountered during the compilation process
+ *
+ * Errors are cheap to create and move. A human-readable message is only
+ * built when `message` is called.
+ */
 struct Error
 {
-	std::string reason;
+	ErrorCode code;
 
 	SourcePosition position;
+
+	/// Get a short description of the error, without its position.
+	[[nodiscard]]
+	std::string_view reason(void) const noexcept { return describe(code); }
+
+	/** Format a message containing the reason and the line and column at
+	 * which the error occurred.
+	 *
+	 * If the position has no characters to count lines in, as for input
+	 * read from a `Source`, the message has the offset instead.
+	 */
+	[[nodiscard]]
+	std::string message(void) const;
 };
 
 using ErrorList = std::vector<Error>;
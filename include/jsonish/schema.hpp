@@ -0,0 +1,159 @@
+#ifndef JSH_SCHEMA_HPP_INCLUDED
+#define JSH_SCHEMA_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+/// The kind of value a schema field holds.
+enum struct ValueKind
+{
+	string,
+	list,
+	object
+};
+
+/// Describes one key expected in an object.
+struct Field
+{
+	std::string key;
+
+	ValueKind kind;
+
+	/// Whether the key must be present.
+	bool required = true;
+};
+
+/** Describes the keys of an object and the kinds of their values.
+ *
+ * Keys are found with a perfect hash built when the schema is constructed,
+ * so looking up a key costs one pass over the key and one string comparison
+ * regardless of the number of fields. Building a schema is comparatively
+ * expensive and should be done once and reused.
+ */
+class Schema
+{
+public:
+	/** Build a schema from a list of fields.
+	 *
+	 * The index of each field in `fields` is its index in a `Record`.
+	 * Throws `std::invalid_argument` if two fields have the same key, or
+	 * in the unlikely case that no perfect hash is found for the keys, as
+	 * when two of them have the same 64-bit hash.
+	 */
+	explicit
+	Schema(std::vector<Field> fields);
+
+	/// Get the number of fields.
+	[[nodiscard]]
+	std::size_t size(void) const noexcept { return fields_.size(); }
+
+	/// Get the field with the given index.
+	[[nodiscard]]
+	Field const& field(std::size_t index) const { return fields_.at(index); }
+
+	/// Get the index of the field with the given key, if there is one.
+	[[nodiscard]]
+	std::optional<std::size_t> index_of(std::string_view key) const noexcept;
+
+private:
+	// Get the slot of a key with the given hash.
+	[[nodiscard]]
+	std::size_t slot_of(std::uint64_t hash) const noexcept;
+
+	// Try to assign every key a distinct slot, given the number of slots.
+	[[nodiscard]]
+	bool try_build(std::size_t slot_count);
+
+	std::vector<Field> fields_;
+
+	/*
+	 * Keys are split into buckets by hash. Each bucket has a displacement,
+	 * chosen so that mixing it into the hashes of the bucket's keys sends
+	 * them to slots not used by any other key. The size is a power of two.
+	 */
+	std::vector<std::uint32_t> displacements_;
+
+	/*
+	 * Maps the slot of each key to one more than the index of its field, or
+	 * to 0 if no key occupies the slot. The size is a power of two.
+	 */
+	std::vector<std::uint32_t> slots_;
+};
+
+/** The values of an object parsed with a `Schema`, stored by field index.
+ *
+ * A record refers to the schema it was parsed with, which must outlive it.
+ */
+class Record
+{
+public:
+	explicit
+	Record(Schema const& schema) :
+		schema_(&schema), values_(schema.size())
+	{}
+
+	/// Get the schema this record was parsed with.
+	[[nodiscard]]
+	Schema const& schema(void) const noexcept { return *schema_; }
+
+	/// Get the number of fields in the schema.
+	[[nodiscard]]
+	std::size_t size(void) const noexcept { return values_.size(); }
+
+	/** Get the value of the field with the given index.
+	 *
+	 * If the index is out of range or the field was not present, produce
+	 * an empty `MaybeValueReference`.
+	 */
+	[[nodiscard]]
+	auto field(std::size_t index) const noexcept -> MaybeValueReference;
+
+	/** Get the value of the field with the given key.
+	 *
+	 * If the key is not in the schema or the field was not present,
+	 * produce an empty `MaybeValueReference`.
+	 */
+	[[nodiscard]]
+	auto property(std::string_view key) const noexcept -> MaybeValueReference;
+
+	/// Set the value of the field with the given index.
+	void set_field(std::size_t index, Value value);
+
+private:
+	Schema const* schema_;
+
+	std::vector<std::optional<Value>> values_;
+};
+
+/** Parse a whole string as an object matching `schema`.
+ *
+ * Parsing stops at the first violation of the schema: a key that is not in
+ * the schema, a value of the wrong kind, or a missing required key. Values
+ * of the correct kind are otherwise unrestricted.
+ *
+ * @param str the string to parse
+ * @param schema the expected shape of the object, which must outlive the
+ * result
+ * @param options controls how `str` is parsed
+ *
+ * @return an invalid result if `str` could not be parsed or does not match
+ * `schema`, or a valid `jsonish::Record` otherwise
+ */
+[[nodiscard]]
+Result<Record> parse(
+	std::string_view str,
+	Schema const& schema,
+	ParseOptions const& options = {});
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef JSH_SHARED_DOCUMENT_HPP_INCLUDED
+#define JSH_SHARED_DOCUMENT_HPP_INCLUDED
+
+#include "jsonish/tree.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace jsonish
+{
+/** Holds a value that many threads read while another replaces it.
+ *
+ * Readers never block or retry: `read` announces the reader by incrementing
+ * one of several counters, spread over cache lines so that threads rarely
+ * share one, and gives access to the current value without copying it.
+ * Replacing the value swaps a pointer, then waits for the readers that may
+ * still see the old value before releasing it. Readers that start during the
+ * wait count towards the other of two sets of counters, as in sleepable
+ * read-copy-update, so a steady stream of readers cannot hold up a
+ * replacement.
+ *
+ * Values are reference counted, so a reader can keep a tree beyond its read
+ * by copying it, which `snapshot` does. A tree is destroyed once the last
+ * such copy is gone.
+ */
+class SharedDocument
+{
+public:
+	/// Grants access to the value that was current when it was created.
+	class Reader
+	{
+	public:
+		Reader(Reader const&) = delete;
+		Reader& operator=(Reader const&) = delete;
+
+		~Reader(void)
+		{
+			counter_->fetch_sub(1, std::memory_order_release);
+		}
+
+		/// Get the value, which is valid as long as this reader.
+		[[nodiscard]]
+		Value const& value(void) const noexcept { return *value_; }
+
+		Value const& operator*(void) const noexcept { return *value_; }
+		Value const* operator->(void) const noexcept { return value_; }
+
+	private:
+		friend class SharedDocument;
+
+		Reader(std::atomic<std::size_t>& counter, Value const& value) noexcept :
+			counter_(&counter), value_(&value)
+		{}
+
+		std::atomic<std::size_t>* counter_;
+		Value const* value_;
+	};
+
+	explicit
+	SharedDocument(Value value = {});
+
+	SharedDocument(SharedDocument const&) = delete;
+	SharedDocument& operator=(SharedDocument const&) = delete;
+
+	~SharedDocument(void);
+
+	/** Get access to the current value.
+	 *
+	 * This never blocks. A reader should be short lived, since replacing
+	 * the value waits for readers that started before it.
+	 */
+	[[nodiscard]]
+	Reader read(void) const noexcept;
+
+	/// Get a copy of the current value, which can be kept indefinitely.
+	[[nodiscard]]
+	Value snapshot(void) const noexcept { return read().value(); }
+
+	/** Replace the value.
+	 *
+	 * Once this returns, every reader sees the new value. Replacements are
+	 * made one at a time. A thread must not replace the value while it
+	 * holds a reader, which would wait for itself.
+	 */
+	void store(Value value);
+
+private:
+	// Wait until every counter for the given epoch has been seen at zero.
+	void wait_for_readers(std::size_t epoch) const noexcept;
+
+	// The number of sets of counters readers are spread over.
+	static constexpr std::size_t shard_count = 16;
+
+	// Counters for readers, one for each of the two epochs.
+	struct alignas(64) Shard
+	{
+		std::array<std::atomic<std::size_t>, 2> readers{};
+	};
+
+	mutable std::array<Shard, shard_count> shards_;
+
+	// Which counter of each shard new readers increment.
+	std::atomic<std::size_t> epoch_{0};
+
+	std::atomic<Value const*> current_;
+
+	std::mutex store_mutex_;
+};
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,636 @@
+#ifndef JSH_STATIC_DOCUMENT_HPP_INCLUDED
+#define JSH_STATIC_DOCUMENT_HPP_INCLUDED
+
+#include "jsonish/detail/chars.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace jsonish
+{
+/** Thrown when a static document literal is not valid jsonish.
+ *
+ * When a static document is built during constant evaluation, as is the case
+ * with `JSONISH_STATIC_DOCUMENT`, this instead makes the program ill-formed,
+ * and the compiler points at the `throw` for the offending error.
+ */
+class StaticParseError : public std::runtime_error
+{
+public:
+	explicit
+	StaticParseError(ErrorCode code, std::size_t offset) :
+		std::runtime_error(std::string(describe(code))),
+		code_(code),
+		offset_(offset)
+	{}
+
+	[[nodiscard]]
+	ErrorCode code(void) const noexcept { return code_; }
+
+	/// Get the offset into the literal at which the error occurred.
+	[[nodiscard]]
+	std::size_t offset(void) const noexcept { return offset_; }
+
+private:
+	ErrorCode code_;
+	std::size_t offset_;
+};
+
+/// The kind of a `StaticNode`.
+enum struct StaticKind
+{
+	string,
+	list,
+	object
+};
+
+/** One value in a `StaticDocument`.
+ *
+ * Nodes are stored in pre-order, so the children of a list or object
+ * immediately follow it. All text refers to the document's characters.
+ */
+struct StaticNode
+{
+	StaticKind kind = StaticKind::string;
+
+	/// For a member of an object, the offset of its key.
+	std::size_t key_offset = 0;
+	std::size_t key_size = 0;
+
+	/// For a string, the offset of its text.
+	std::size_t text_offset = 0;
+	std::size_t text_size = 0;
+
+	/// For a list or object, the number of children.
+	std::size_t child_count = 0;
+
+	/// The index one past the last node in this node's subtree.
+	std::size_t subtree_end = 0;
+};
+
+/** A read-only view of a value in a `StaticDocument`.
+ *
+ * This mirrors the interface of `jsonish::MaybeValueReference`. Views may be
+ * empty, which is the case when a property or index does not exist.
+ */
+class StaticValue
+{
+public:
+	/// Create an empty view.
+	constexpr
+	StaticValue(void) noexcept :
+		nodes_(nullptr), chars_(nullptr), index_(0)
+	{}
+
+	constexpr
+	StaticValue(
+		StaticNode const* nodes,
+		char const* chars,
+		std::size_t index) noexcept :
+		nodes_(nodes), chars_(chars), index_(index)
+	{}
+
+	/// Indicate whether this view refers to a value.
+	[[nodiscard]] constexpr
+	bool exists(void) const noexcept { return nodes_ != nullptr; }
+
+	[[nodiscard]] constexpr
+	bool is_string(void) const noexcept
+	{
+		return exists() && node().kind == StaticKind::string;
+	}
+
+	[[nodiscard]] constexpr
+	bool is_list(void) const noexcept
+	{
+		return exists() && node().kind == StaticKind::list;
+	}
+
+	[[nodiscard]] constexpr
+	bool is_object(void) const noexcept
+	{
+		return exists() && node().kind == StaticKind::object;
+	}
+
+	/** Get the text of a string value.
+	 *
+	 * Throws `std::logic_error` if this is not a string.
+	 */
+	[[nodiscard]] constexpr
+	std::string_view as_string(void) const
+	{
+		if (!is_string())
+		{
+			throw std::logic_error("static value is not a string");
+		}
+		return text(node().text_offset, node().text_size);
+	}
+
+	/** Get the key of this value within its parent object.
+	 *
+	 * This is empty if the parent is not an object.
+	 */
+	[[nodiscard]] constexpr
+	std::string_view key(void) const noexcept
+	{
+		if (!exists())
+		{
+			return {};
+		}
+		return text(node().key_offset, node().key_size);
+	}
+
+	/// Get the number of children of a list or object, or 0 otherwise.
+	[[nodiscard]] constexpr
+	std::size_t size(void) const noexcept
+	{
+		return exists() ? node().child_count : 0;
+	}
+
+	/** Get the child at `index` in a list or object.
+	 *
+	 * If this is not a list or object, or it has no such child, produce an
+	 * empty view.
+	 */
+	[[nodiscard]] constexpr
+	StaticValue at(std::size_t index) const noexcept
+	{
+		if (index >= size())
+		{
+			return StaticValue();
+		}
+
+		auto child = index_ + 1;
+		for (std::size_t i = 0; i < index; ++i)
+		{
+			child = nodes_[child].subtree_end;
+		}
+		return StaticValue(nodes_, chars_, child);
+	}
+
+	/** Get the member with the given key in an object.
+	 *
+	 * If this is not an object or has no such member, produce an empty
+	 * view.
+	 */
+	[[nodiscard]] constexpr
+	StaticValue property(std::string_view key) const noexcept
+	{
+		if (!is_object())
+		{
+			return StaticValue();
+		}
+
+		auto child = index_ + 1;
+		for (std::size_t i = 0; i < size(); ++i)
+		{
+			auto const& child_node = nodes_[child];
+			if (text(child_node.key_offset, child_node.key_size) == key)
+			{
+				return StaticValue(nodes_, chars_, child);
+			}
+			child = child_node.subtree_end;
+		}
+		return StaticValue();
+	}
+
+	/** Copy this value into a runtime `jsonish::Value`.
+	 *
+	 * Throws `std::logic_error` if this view is empty.
+	 */
+	[[nodiscard]]
+	Value to_value(void) const;
+
+private:
+	[[nodiscard]] constexpr
+	StaticNode const& node(void) const noexcept { return nodes_[index_]; }
+
+	[[nodiscard]] constexpr
+	std::string_view text(std::size_t offset, std::size_t size) const noexcept
+	{
+		if (size == 0)
+		{
+			return {};
+		}
+		return std::string_view(chars_ + offset, size);
+	}
+
+	StaticNode const* nodes_;
+	char const* chars_;
+	std::size_t index_;
+};
+
+/// The storage needed by a `StaticDocument` for some literal.
+struct StaticDocumentSize
+{
+	std::size_t nodes = 0;
+	std::size_t chars = 0;
+};
+
+namespace detail
+{
+// Counts the storage needed for a static document without storing anything.
+class StaticSizeCounter
+{
+public:
+	[[nodiscard]] constexpr
+	StaticDocumentSize size(void) const noexcept { return size_; }
+
+	constexpr
+	std::size_t char_count(void) const noexcept { return size_.chars; }
+
+	constexpr
+	void push_char(char) noexcept { ++size_.chars; }
+
+	constexpr
+	std::size_t add_node(StaticNode const&) noexcept { return size_.nodes++; }
+
+	constexpr
+	void finish_node(std::size_t, std::size_t) noexcept {}
+
+	// Keys are not stored, so duplicates are found when the document is built.
+	[[nodiscard]] constexpr
+	bool has_key(std::size_t, std::size_t, std::size_t, std::size_t)
+		const noexcept
+	{
+		return false;
+	}
+
+private:
+	StaticDocumentSize size_;
+};
+
+/*
+ * A recursive descent parser usable in constant expressions. It accepts
+ * exactly what `jsonish::parse` accepts with default options and reports
+ * nodes and decoded characters to `Builder`.
+ */
+template <typename Builder>
+class StaticParser
+{
+public:
+	constexpr
+	StaticParser(std::string_view chars, Builder& builder) noexcept :
+		chars_(chars), pos_(0), builder_(builder)
+	{}
+
+	constexpr
+	void parse_document(void)
+	{
+		parse_value(0, 0);
+		skip_space();
+		if (pos_ != chars_.size())
+		{
+			throw StaticParseError(ErrorCode::trailing_characters, pos_);
+		}
+	}
+
+private:
+	constexpr
+	void skip_space(void) noexcept
+	{
+		while (pos_ < chars_.size() && is_space(chars_[pos_]))
+		{
+			++pos_;
+		}
+	}
+
+	// Skip whitespace and then try to read the character `c`.
+	constexpr
+	bool try_extract(char c) noexcept
+	{
+		skip_space();
+		if (pos_ < chars_.size() && chars_[pos_] == c)
+		{
+			++pos_;
+			return true;
+		}
+		return false;
+	}
+
+	constexpr
+	void parse_value(std::size_t key_offset, std::size_t key_size)
+	{
+		StaticNode node;
+		node.key_offset = key_offset;
+		node.key_size = key_size;
+
+		if (try_extract('"'))
+		{
+			node.kind = StaticKind::string;
+			node.text_offset = builder_.char_count();
+			parse_string_contents();
+			node.text_size = builder_.char_count() - node.text_offset;
+			builder_.add_node(node);
+		}
+		else if (try_extract('['))
+		{
+			node.kind = StaticKind::list;
+			parse_list(builder_.add_node(node));
+		}
+		else if (try_extract('{'))
+		{
+			node.kind = StaticKind::object;
+			parse_object(builder_.add_node(node));
+		}
+		else
+		{
+			throw StaticParseError(ErrorCode::expected_value, pos_);
+		}
+	}
+
+	constexpr
+	void parse_list(std::size_t index)
+	{
+		std::size_t count = 0;
+		if (!try_extract(']'))
+		{
+			do
+			{
+				parse_value(0, 0);
+				++count;
+			} while (try_extract(','));
+
+			if (!try_extract(']'))
+			{
+				throw StaticParseError(ErrorCode::expected_rbracket, pos_);
+			}
+		}
+		builder_.finish_node(index, count);
+	}
+
+	constexpr
+	void parse_object(std::size_t index)
+	{
+		std::size_t count = 0;
+		if (!try_extract('}'))
+		{
+			do
+			{
+				skip_space();
+				auto const key_start = pos_;
+				if (!try_extract('"'))
+				{
+					throw StaticParseError(ErrorCode::expected_key, pos_);
+				}
+
+				auto const key_offset = builder_.char_count();
+				parse_string_contents();
+				auto const key_size = builder_.char_count() - key_offset;
+				if (builder_.has_key(index, count, key_offset, key_size))
+				{
+					throw StaticParseError(
+						ErrorCode::duplicate_key, key_start);
+				}
+
+				if (!try_extract(':'))
+				{
+					throw StaticParseError(ErrorCode::expected_colon, pos_);
+				}
+				parse_value(key_offset, key_size);
+				++count;
+			} while (try_extract(','));
+
+			if (!try_extract('}'))
+			{
+				throw StaticParseError(ErrorCode::expected_rbrace, pos_);
+			}
+		}
+		builder_.finish_node(index, count);
+	}
+
+	// Read the character at the current position, which must exist.
+	constexpr
+	char extract_char(void)
+	{
+		if (pos_ == chars_.size())
+		{
+			throw StaticParseError(ErrorCode::no_closing_quote, pos_);
+		}
+		return chars_[pos_++];
+	}
+
+	constexpr
+	std::uint32_t extract_code_unit(void)
+	{
+		std::uint32_t unit = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			auto const digit = hex_digit_value(extract_char());
+			if (digit < 0)
+			{
+				throw StaticParseError(
+					ErrorCode::expected_hex_digit, pos_);
+			}
+			unit = (unit << 4) | static_cast<std::uint32_t>(digit);
+		}
+		return unit;
+	}
+
+	// Decode a string after its opening quote, including the closing quote.
+	constexpr
+	void parse_string_contents(void)
+	{
+		while (true)
+		{
+			char const c = extract_char();
+			if (c == '"')
+			{
+				return;
+			}
+			if (is_disallowed_in_string(c))
+			{
+				throw StaticParseError(
+					ErrorCode::invalid_character_in_string, pos_);
+			}
+			if (c != '\\')
+			{
+				builder_.push_char(c);
+				continue;
+			}
+
+			char const escaped = extract_char();
+			if (!is_escapable(escaped))
+			{
+				throw StaticParseError(
+					ErrorCode::invalid_escape_sequence, pos_);
+			}
+			if (escaped != 'u')
+			{
+				builder_.push_char(map_escaped_char(escaped));
+				continue;
+			}
+
+			auto code_point = extract_code_unit();
+			if (is_high_surrogate(code_point)
+				&& chars_.substr(pos_, 2) == "\\u")
+			{
+				auto const saved_pos = pos_;
+				pos_ += 2;
+				auto const low = extract_code_unit();
+				if (is_low_surrogate(low))
+				{
+					code_point = combine_surrogates(code_point, low);
+				}
+				else
+				{
+					pos_ = saved_pos;
+				}
+			}
+			encode_utf8(code_point, [this](char byte) {
+				builder_.push_char(byte);
+			});
+		}
+	}
+
+	std::string_view chars_;
+	std::size_t pos_;
+	Builder& builder_;
+};
+} // namespace detail
+
+/** Measure the storage needed to hold `literal` as a `StaticDocument`.
+ *
+ * Throws `StaticParseError` if `literal` is not valid jsonish.
+ */
+[[nodiscard]] constexpr
+StaticDocumentSize measure_static_document(std::string_view literal)
+{
+	detail::StaticSizeCounter counter;
+	detail::StaticParser<detail::StaticSizeCounter>(literal, counter)
+		.parse_document();
+	return counter.size();
+}
+
+/** A jsonish document parsed at compile time.
+ *
+ * The whole document lives in two fixed-size arrays, so a `constexpr`
+ * instance is placed in read-only storage and costs nothing to parse at
+ * runtime. Instances are normally created with `JSONISH_STATIC_DOCUMENT`.
+ */
+template <std::size_t NodeCount, std::size_t CharCount>
+class StaticDocument
+{
+public:
+	/** Parse `literal`, which must need exactly the given storage.
+	 *
+	 * Throws `StaticParseError` if `literal` is not valid jsonish, and
+	 * `std::length_error` if its size does not match.
+	 */
+	explicit constexpr
+	StaticDocument(std::string_view literal)
+	{
+		auto const size = measure_static_document(literal);
+		if (size.nodes != NodeCount || size.chars != CharCount)
+		{
+			throw std::length_error(
+				"static document storage does not match literal");
+		}
+		detail::StaticParser<StaticDocument>(literal, *this)
+			.parse_document();
+	}
+
+	/// Get a view of the top-level value.
+	[[nodiscard]] constexpr
+	StaticValue root(void) const noexcept
+	{
+		return StaticValue(nodes_.data(), chars_.data(), 0);
+	}
+
+	/// Get the value with the given key in a top-level object.
+	[[nodiscard]] constexpr
+	StaticValue property(std::string_view key) const noexcept
+	{
+		return root().property(key);
+	}
+
+	/// Get the value at the given index in a top-level list.
+	[[nodiscard]] constexpr
+	StaticValue at(std::size_t index) const noexcept
+	{
+		return root().at(index);
+	}
+
+	/// Copy the whole document into a runtime `jsonish::Value`.
+	[[nodiscard]]
+	Value to_value(void) const { return root().to_value(); }
+
+private:
+	friend class detail::StaticParser<StaticDocument>;
+
+	constexpr
+	std::size_t char_count(void) const noexcept { return char_count_; }
+
+	constexpr
+	void push_char(char c) noexcept { chars_[char_count_++] = c; }
+
+	constexpr
+	std::size_t add_node(StaticNode const& node) noexcept
+	{
+		nodes_[node_count_] = node;
+		nodes_[node_count_].subtree_end = node_count_ + 1;
+		return node_count_++;
+	}
+
+	constexpr
+	void finish_node(std::size_t index, std::size_t child_count) noexcept
+	{
+		nodes_[index].child_count = child_count;
+		nodes_[index].subtree_end = node_count_;
+	}
+
+	/*
+	 * Check whether any of the first `count` members of the object at
+	 * `index` has the key stored at [offset, offset + size).
+	 */
+	[[nodiscard]] constexpr
+	bool has_key(
+		std::size_t index,
+		std::size_t count,
+		std::size_t offset,
+		std::size_t size) const noexcept
+	{
+		auto const key = std::string_view(chars_.data() + offset, size);
+
+		auto child = index + 1;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			auto const& node = nodes_[child];
+			auto const other = std::string_view(
+				chars_.data() + node.key_offset, node.key_size);
+			if (other == key)
+			{
+				return true;
+			}
+			child = node.subtree_end;
+		}
+		return false;
+	}
+
+	std::array<StaticNode, NodeCount> nodes_{};
+	std::array<char, CharCount> chars_{};
+
+	std::size_t node_count_ = 0;
+	std::size_t char_count_ = 0;
+};
+} // namespace jsonish
+
+/** Parse `literal` into a `StaticDocument` of exactly the right size.
+ *
+ * This has to be a macro so that `literal` can be measured in a constant
+ * expression before the document type is chosen. A malformed literal makes
+ * the program ill-formed when the result initializes a `constexpr`
+ * variable.
+ */
+#define JSONISH_STATIC_DOCUMENT(literal) \
+	::jsonish::StaticDocument< \
+		::jsonish::measure_static_document(literal).nodes, \
+		::jsonish::measure_static_document(literal).chars>(literal)
+
+#endif
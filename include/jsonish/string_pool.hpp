@@ -0,0 +1,104 @@
+#ifndef JSH_STRING_POOL_HPP_INCLUDED
+#define JSH_STRING_POOL_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+/** Shares the storage of equal strings between values.
+ *
+ * Strings too long to be stored inline in a `Value` each take a node of
+ * their own. A pool remembers one value for each such string it has seen,
+ * and hands out copies of it, which share its node, for equal strings.
+ * Shorter strings take no storage beyond the value itself, so they are
+ * passed through.
+ *
+ * Only string values are pooled. Object keys are stored by their objects,
+ * each with its own storage, so they are neither shared nor counted.
+ *
+ * A pool keeps its strings alive until it is cleared or destroyed. It is
+ * meant to be scoped to a document, or to a set of similar documents, and
+ * must not be used by several threads at once.
+ */
+class StringPool
+{
+public:
+	/** Counts of the string values a pool has been given.
+	 *
+	 * Only values too long to be stored inline are counted, since shorter
+	 * strings are passed through.
+	 */
+	struct Stats
+	{
+		/// The number of strings long enough to be pooled.
+		std::size_t strings = 0;
+
+		/// The number of those that shared the storage of an earlier one.
+		std::size_t shared = 0;
+
+		/// The bytes of storage sharing avoided keeping.
+		std::size_t bytes_saved = 0;
+	};
+
+	/// Get a value holding `str`, sharing storage with an equal string.
+	[[nodiscard]]
+	Value intern(std::string str);
+
+	/// Get the number of distinct strings held.
+	[[nodiscard]]
+	std::size_t size(void) const noexcept { return values_.size(); }
+
+	/// Get counts of the strings given to this pool so far.
+	[[nodiscard]]
+	Stats const& stats(void) const noexcept { return stats_; }
+
+	/// Release every string held and reset the counts.
+	void clear(void) noexcept;
+
+private:
+	// Put the value at `index` into the first free slot for its hash.
+	void place(std::size_t index) noexcept;
+
+	// One value for each distinct string.
+	std::vector<Value> values_;
+
+	// The hash of each string, in the same order as `values_`.
+	std::vector<std::uint64_t> hashes_;
+
+	/*
+	 * A linearly probed hash table mapping slots to one more than the index
+	 * of a value, or to 0 for a free slot. Its size is a power of two at
+	 * least twice the number of values.
+	 */
+	std::vector<std::uint32_t> slots_;
+
+	Stats stats_;
+};
+
+/** Parse a whole string, sharing the storage of equal strings.
+ *
+ * This behaves like `parse`, but passes each string value through `pool`,
+ * so a string repeated across a document is stored once. Keys are stored
+ * by their objects as before.
+ *
+ * @param str the string to parse
+ * @param pool shares strings, and counts how much it saved
+ * @param options controls how `str` is parsed
+ *
+ * @return an invalid result if `str` could not be parsed, or a valid
+ * `jsonish::Value` otherwise
+ */
+[[nodiscard]]
+Result<Value> parse(
+	std::string_view str, StringPool& pool, ParseOptions const& options = {});
+} // namespace jsonish
+
+#endif
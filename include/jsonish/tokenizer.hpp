@@ -0,0 +1,128 @@
+#ifndef JSH_TOKENIZER_HPP_INCLUDED
+#define JSH_TOKENIZER_HPP_INCLUDED
+
+#include "jsonish/parse_options.hpp"
+#include "jsonish/result.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+/// The kind of a `CompactToken`.
+enum struct TokenKind : std::uint8_t
+{
+	string,
+	lbrace,
+	rbrace,
+	lbracket,
+	rbracket,
+	comma,
+	colon
+};
+
+/** A token that refers to its characters instead of holding them.
+ *
+ * The text of a string token is only decoded when asked for, with
+ * `Tokenizer::text` or `Tokenizer::decode`.
+ */
+struct CompactToken
+{
+	TokenKind kind;
+
+	/// Whether a string token contains escape sequences.
+	bool has_escapes;
+
+	/// The offset of the token's first character in the input.
+	std::uint32_t offset;
+
+	/// The number of characters in the token, including any quotes.
+	std::uint32_t length;
+};
+
+/** Splits a whole input into `CompactToken`s in one pass.
+ *
+ * Strings are checked while tokenizing, so decoding them later cannot fail.
+ * The token buffer is kept between calls to `tokenize`, so a tokenizer can be
+ * reused for many inputs without allocating. The input must outlive any use
+ * of the tokens produced from it.
+ */
+class Tokenizer
+{
+public:
+	/** Construct a tokenizer.
+	 *
+	 * @param options controls how strings are checked
+	 */
+	explicit
+	Tokenizer(ParseOptions const& options = {}) noexcept :
+		options_(options)
+	{}
+
+	/** Replace the tokens with those of `chars`.
+	 *
+	 * Tokenizing stops at the first invalid token, whose error can be
+	 * obtained with `error`. The tokens before it are kept. Throws
+	 * `std::length_error` if `chars` has 4 GiB or more of characters.
+	 *
+	 * @return `true` if all of `chars` was tokenized
+	 */
+	bool tokenize(std::string_view chars);
+
+	/// Get the tokens produced by the last call to `tokenize`.
+	[[nodiscard]]
+	std::vector<CompactToken> const& tokens(void) const noexcept
+	{
+		return tokens_;
+	}
+
+	/// Get the error that stopped the last call to `tokenize`, if any.
+	[[nodiscard]]
+	std::optional<Error> const& error(void) const noexcept
+	{
+		return error_;
+	}
+
+	/// Get the characters of a token, including any quotes.
+	[[nodiscard]]
+	std::string_view raw(CompactToken const& token) const noexcept
+	{
+		return source_.substr(token.offset, token.length);
+	}
+
+	/** Get the characters between the quotes of a string token.
+	 *
+	 * If the token has no escapes, this is its text and no decoding is
+	 * needed. `token` must be a string token.
+	 */
+	[[nodiscard]]
+	std::string_view contents(CompactToken const& token) const noexcept
+	{
+		assert(token.kind == TokenKind::string);
+		return source_.substr(token.offset + 1, token.length - 2);
+	}
+
+	/// Append the decoded text of a string token to `out`.
+	void decode(CompactToken const& token, std::string& out) const;
+
+	/// Get the decoded text of a string token.
+	[[nodiscard]]
+	std::string text(CompactToken const& token) const;
+
+private:
+	ParseOptions options_;
+
+	std::string_view source_;
+
+	std::vector<CompactToken> tokens_;
+
+	std::optional<Error> error_;
+};
+} // namespace jsonish
+
+#endif
@@ -1,8 +1,13 @@
 #ifndef JSH_TREE_HPP_INCLUDED
 #define JSH_TREE_HPP_INCLUDED
 
+#include "jsonish/detail/hash.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <functional>
-#include <map>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -16,12 +21,74 @@ class List;
 class Value;
 class MaybeValueReference;
 
+/** A key prepared for repeated lookups with `Object::property`.
+ *
+ * A handle holds the key, its hash, and the index at which the key was last
+ * found. Objects of the same shape keep a key at the same index, so once a
+ * handle has been used, looking it up in another object of that shape costs
+ * one hash comparison and one string comparison. Handles can be shared between
+ * threads.
+ */
+class KeyHandle
+{
+public:
+	explicit
+	KeyHandle(std::string key) :
+		key_(std::move(key)), hash_(detail::hash_key(key_)), hint_(0)
+	{}
+
+	KeyHandle(KeyHandle const& other) :
+		key_(other.key_), hash_(other.hash_), hint_(other.hint())
+	{}
+
+	KeyHandle& operator=(KeyHandle const& other)
+	{
+		key_ = other.key_;
+		hash_ = other.hash_;
+		hint_.store(other.hint(), std::memory_order_relaxed);
+		return *this;
+	}
+
+	[[nodiscard]]
+	std::string_view key(void) const noexcept { return key_; }
+
+	[[nodiscard]]
+	std::uint64_t hash(void) const noexcept { return hash_; }
+
+private:
+	friend class Object;
+
+	[[nodiscard]]
+	std::size_t hint(void) const noexcept
+	{
+		return hint_.load(std::memory_order_relaxed);
+	}
+
+	void set_hint(std::size_t index) const noexcept
+	{
+		hint_.store(index, std::memory_order_relaxed);
+	}
+
+	std::string key_;
+	std::uint64_t hash_;
+
+	/*
+	 * Only ever a guess, so races between threads updating it are harmless
+	 * as long as each load and store is atomic.
+	 */
+	mutable std::atomic<std::size_t> hint_;
+};
+
 /// Contains a sequence of jsonish values.
 class List
 {
 public:
 	List(void) noexcept = default;
 
+	/// Construct a list holding the given values in order.
+	explicit
+	List(std::vector<Value> values) noexcept : values_(std::move(values)) {}
+
 	List(List const&) = default;
 	List(List&&) noexcept = default;
 
@@ -66,15 +133,44 @@ private:
 	std::vector<Value> values_;
 };
 
+/// How an `Object` finds members by key.
+enum struct ObjectStorage
+{
+	/** Use `hashed` for objects with at least `hashed_object_threshold`
+	 * members and `sorted` for smaller ones.
+	 */
+	automatic,
+
+	/// Binary search the members, which are always sorted by key.
+	sorted,
+
+	/// Also index the members with an open-addressing hash table.
+	hashed
+};
+
+/// The number of members at which `ObjectStorage::automatic` hashes objects.
+inline constexpr std::size_t hashed_object_threshold = 16;
+
 /** Contains key-value pairs of strings and jsonish values.
  *
- * An `Object` does not allow duplicate keys.
+ * An `Object` does not allow duplicate keys. Members are stored contiguously
+ * and iterated in order of their keys, and can only be changed through the
+ * member functions, which keep them sorted and indexed.
+ *
+ * Small objects are binary searched. Wide objects can additionally be indexed
+ * by a hash table, as chosen by their `ObjectStorage`. Inserting a member
+ * takes time linear in the size of the object, so objects should be built
+ * with `assign` where possible.
  */
 class Object
 {
 public:
 	Object(void) noexcept = default;
 
+	/// Construct an empty object that finds members as `storage` says.
+	explicit
+	Object(ObjectStorage storage) noexcept : storage_(storage) {}
+
 	Object(Object const&) = default;
 	Object(Object&&) noexcept = default;
 
@@ -87,15 +183,30 @@ public:
 	auto end(void) const noexcept { return std::cend(values_); }
 
 	[[nodiscard]]
-	auto begin(void) noexcept { return std::begin(values_); }
+	std::size_t size(void) const noexcept { return values_.size(); }
+
 	[[nodiscard]]
-	auto end(void) noexcept { return std::end(values_); }
+	bool is_empty(void) const noexcept { return values_.empty(); }
 
+	/// Get how this object was asked to find members.
 	[[nodiscard]]
-	std::size_t size(void) const noexcept { return values_.size(); }
+	ObjectStorage storage(void) const noexcept { return storage_; }
 
+	/// Indicate whether members are currently indexed by a hash table.
 	[[nodiscard]]
-	bool is_empty(void) const noexcept { return values_.empty(); }
+	bool is_hashed(void) const noexcept { return !slots_.empty(); }
+
+	/** Replace all members at once.
+	 *
+	 * `members` may be in any order. They are sorted and indexed once,
+	 * which is much cheaper than inserting them one at a time.
+	 *
+	 * @return the index in `members` of the first member whose key was
+	 * already used by an earlier member, in which case the object is left
+	 * empty, or an empty optional otherwise.
+	 */
+	std::optional<std::size_t> assign(
+		std::vector<std::pair<std::string, Value>> members);
 
 	/** Attempt to insert a key-value pair into the object.
 	 *
@@ -117,6 +228,12 @@ public:
 	void set_property(std::string key, Value const& value);
 	void set_property(std::string key, Value&& value);
 
+	/** Remove the member with the given key, if there is one.
+	 *
+	 * @return `true` if a member was removed and `false` otherwise.
+	 */
+	bool erase(std::string_view key);
+
 	/** Attempt to get the value associated with a key.
 	 *
 	 * If `key` does not exist in this object, produces an empty optional.
@@ -126,6 +243,16 @@ public:
 	[[nodiscard]]
 	auto property(std::string_view key) const noexcept -> MaybeValueReference;
 
+	/** Attempt to get the value associated with a prepared key.
+	 *
+	 * This behaves like `property(handle.key())`, but checks the index
+	 * remembered by `handle` first and updates it when the key is found
+	 * elsewhere.
+	 */
+	[[nodiscard]]
+	auto property(KeyHandle const& handle) const noexcept
+		-> MaybeValueReference;
+
 	friend
 	bool operator==(Object const& a, Object const& b);
 
@@ -133,74 +260,169 @@ public:
 	bool operator!=(Object const& a, Object const& b);
 
 private:
-	// Comparator to allow finding elements with `std::string_view`.
-	struct StringViewComparator
-	{
-		using is_transparent = void;
-		bool operator()(
-			std::string_view a, std::string_view b) const noexcept
-		{
-			return std::less<>{}(a, b);
-		}
-	};
+	// Find the index of the first member whose key is not less than `key`.
+	[[nodiscard]]
+	std::size_t lower_bound(std::string_view key) const noexcept;
+
+	// Find the index of the member with the given key.
+	[[nodiscard]]
+	std::optional<std::size_t> find(std::string_view key) const noexcept;
+
+	// Find the index of the member with the given key and hash.
+	[[nodiscard]]
+	std::optional<std::size_t> find(
+		std::string_view key, std::uint64_t hash) const noexcept;
+
+	// Insert a new member before the member at `index`.
+	void insert_at(std::size_t index, std::string key, Value value);
+
+	// Indicate whether `storage_` calls for a hash table at this size.
+	[[nodiscard]]
+	bool wants_index(void) const noexcept;
+
+	// Rebuild or discard the hash table to match `storage_`.
+	void update_index(void);
+
+	// Put the member at `index` into the first free slot for its hash.
+	void place_in_index(std::size_t index) noexcept;
+
+	ObjectStorage storage_ = ObjectStorage::automatic;
+
+	// Members, sorted by key.
+	std::vector<std::pair<std::string, Value>> values_;
+
+	// The hash of each member's key, in the same order as `values_`.
+	std::vector<std::uint64_t> hashes_;
 
 	/*
-	 * Every compiler I have tested this with has allowed it. However, I am
-	 * almost completely sure this is undefined behavior, as `Object` (and
-	 * therefore `Value`) is not complete until the closing brace of this
-	 * class.
-	 *
-	 * One possible way this could be fixed is to wrap the `Value`s in the
-	 * multimap in `std::unique_ptr`.
+	 * A linearly probed hash table mapping slots to one more than the index
+	 * of a member, or to 0 for a free slot. Its size is a power of two at
+	 * least twice the number of members, so probing always reaches a free
+	 * slot. It is empty when the object is not hashed.
 	 */
-	std::map<std::string, Value, StringViewComparator> values_;
+	std::vector<std::uint32_t> slots_;
+};
+
+namespace detail
+{
+// The reference count at the start of every node a `Value` can point to.
+struct SharedHeader
+{
+	std::atomic<std::size_t> references{1};
+};
+
+#ifdef JSONISH_COUNT_COPIES
+/*
+ * The number of times a `Value` has been copied. This is only counted when
+ * `JSONISH_COUNT_COPIES` is defined, which tests use to check that parsing
+ * moves values rather than copying them.
+ */
+inline std::atomic<std::size_t> value_copies{0};
+#endif
+
+// Out-of-line storage for a `Value`, shared by all copies of that value.
+template <typename T>
+struct SharedNode : SharedHeader
+{
+	explicit
+	SharedNode(T v) : value(std::move(v)) {}
+
+	T value;
 };
+} // namespace detail
 
-/// Holds either an `Object`, `std::string`, or `List`.
+/** Holds either an `Object`, a string, or a `List`.
+ *
+ * A value takes 16 bytes. Strings of up to 15 bytes are stored inline, while
+ * longer strings, objects, and lists are stored in reference counted nodes.
+ * Since a value cannot be modified except by assigning to it, copies share
+ * these nodes, so copying a value takes constant time regardless of its size.
+ */
 class Value
 {
 public:
-	Value(std::string str) : value_(std::move(str)) {}
-	Value(List list) : value_(std::move(list)) {}
-	Value(Object object) : value_(std::move(object)) {}
+	/// The length of the longest string stored inline rather than in a node.
+	static constexpr std::size_t max_inline_string = 15;
+
+	/// Construct an empty string value.
+	Value(void) noexcept : bytes_{} {}
+
+	Value(std::string str);
+	Value(List list);
+	Value(Object object);
 
 	/** Construct a string value.
 	 *
 	 * This is required to allow values to be constructed using string
 	 * literals.
 	 */
-	Value(char const* str) : value_(str) {}
+	Value(char const* str);
+
+	Value(Value const& other) noexcept
+	{
+		std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+		retain();
+		count_copy();
+	}
+
+	Value(Value&& other) noexcept
+	{
+		std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+		other.bytes_[tag_index] = 0;
+	}
+
+	Value& operator=(Value const& other) noexcept
+	{
+		// Retaining first makes self-assignment safe.
+		other.retain();
+		release();
+		std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+		count_copy();
+		return *this;
+	}
+
+	Value& operator=(Value&& other) noexcept
+	{
+		if (this != &other)
+		{
+			release();
+			std::memcpy(bytes_, other.bytes_, sizeof(bytes_));
+			other.bytes_[tag_index] = 0;
+		}
+		return *this;
+	}
+
+	~Value(void) { release(); }
 
 	/// Indicate whether this value is a string.
 	[[nodiscard]]
 	bool is_string(void) const noexcept
 	{
-		return std::holds_alternative<std::string>(value_);
+		return tag() <= long_string_tag;
 	}
 
 	/// Indicate whether this value is an object.
 	[[nodiscard]]
-	bool is_object(void) const noexcept
-	{
-		return std::holds_alternative<Object>(value_);
-	}
+	bool is_object(void) const noexcept { return tag() == object_tag; }
 
 	/// Indicate whether this value is a list.
 	[[nodiscard]]
-	bool is_list(void) const noexcept
-	{
-		return std::holds_alternative<List>(value_);
-	}
+	bool is_list(void) const noexcept { return tag() == list_tag; }
 
-	/** Get a reference to the contained string value.
+	/** Get the contained string value.
 	 *
-	 * If the contained value is not a string, throw
+	 * The string is valid for as long as this value, or a copy of it,
+	 * exists. If the contained value is not a string, throw
 	 * `std::bad_variant_access`.
 	 */
 	[[nodiscard]]
-	auto as_string(void) const -> std::string const&
+	auto as_string(void) const -> std::string_view
 	{
-		return std::get<std::string>(value_);
+		if (tag() <= inline_capacity)
+		{
+			return std::string_view(bytes_, tag());
+		}
+		return node_value<std::string>(long_string_tag);
 	}
 
 	/** Get a reference to the contained object value.
@@ -211,7 +433,7 @@ public:
 	[[nodiscard]]
 	auto as_object(void) const -> Object const&
 	{
-		return std::get<Object>(value_);
+		return node_value<Object>(object_tag);
 	}
 
 	/** Get a reference to the contained list value.
@@ -222,7 +444,7 @@ public:
 	[[nodiscard]]
 	auto as_list(void) const -> List const&
 	{
-		return std::get<List>(value_);
+		return node_value<List>(list_tag);
 	}
 
 	/** Attempt to get a value with the specified key in an object.
@@ -234,6 +456,11 @@ public:
 	[[nodiscard]]
 	auto property(std::string_view key) const noexcept -> MaybeValueReference;
 
+	/// Like `property(std::string_view)`, but using a prepared key.
+	[[nodiscard]]
+	auto property(KeyHandle const& handle) const noexcept
+		-> MaybeValueReference;
+
 	/** Attempt to get a value with the specified index in a list.
 	 *
 	 * If the value is not a list, or if the index does not exist,
@@ -243,6 +470,21 @@ public:
 	[[nodiscard]]
 	auto at(std::size_t index) const noexcept -> MaybeValueReference;
 
+	/** Indicate whether this value and `other` are copies of one another.
+	 *
+	 * This compares where the contents are stored rather than the contents
+	 * themselves, so it takes constant time. Copies are always equal, but
+	 * equal values need not be copies. Strings short enough to be stored
+	 * inline are never considered copies.
+	 */
+	[[nodiscard]]
+	bool shares_storage_with(Value const& other) const noexcept
+	{
+		return tag() > inline_capacity
+			&& tag() == other.tag()
+			&& node() == other.node();
+	}
+
 	friend
 	bool operator==(Value const& a, Value const& b);
 
@@ -250,7 +492,81 @@ public:
 	bool operator!=(Value const& a, Value const& b);
 
 private:
-	std::variant<std::string, Object, List> value_;
+	/*
+	 * The last byte holds the size of an inline string, or one of the tags
+	 * below for values stored in a node. The node pointer is held in the
+	 * first bytes.
+	 */
+	static constexpr std::size_t tag_index = 15;
+	static constexpr std::size_t inline_capacity = tag_index;
+	static_assert(inline_capacity == max_inline_string);
+	static constexpr unsigned char long_string_tag = inline_capacity + 1;
+	static constexpr unsigned char object_tag = long_string_tag + 1;
+	static constexpr unsigned char list_tag = object_tag + 1;
+
+	[[nodiscard]]
+	unsigned char tag(void) const noexcept
+	{
+		return static_cast<unsigned char>(bytes_[tag_index]);
+	}
+
+	[[nodiscard]]
+	detail::SharedHeader* node(void) const noexcept
+	{
+		detail::SharedHeader* held;
+		std::memcpy(&held, bytes_, sizeof(held));
+		return held;
+	}
+
+	// Point to a newly created node.
+	template <typename T>
+	void set_node(T value, unsigned char node_tag)
+	{
+		detail::SharedHeader* const new_node =
+			new detail::SharedNode<T>(std::move(value));
+		std::memcpy(bytes_, &new_node, sizeof(new_node));
+		bytes_[tag_index] = static_cast<char>(node_tag);
+	}
+
+	// Get the value held by the node, which must have the given tag.
+	template <typename T>
+	[[nodiscard]]
+	T const& node_value(unsigned char expected_tag) const
+	{
+		if (tag() != expected_tag)
+		{
+			throw std::bad_variant_access();
+		}
+		return static_cast<detail::SharedNode<T> const*>(node())->value;
+	}
+
+	void retain(void) const noexcept
+	{
+		if (tag() > inline_capacity)
+		{
+			node()->references.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void release(void) noexcept
+	{
+		if (tag() > inline_capacity)
+		{
+			release_node();
+		}
+	}
+
+	static void count_copy(void) noexcept
+	{
+#ifdef JSONISH_COUNT_COPIES
+		detail::value_copies.fetch_add(1, std::memory_order_relaxed);
+#endif
+	}
+
+	// Drop a reference to the node, destroying it if it was the last.
+	void release_node(void) noexcept;
+
+	alignas(detail::SharedHeader*) char bytes_[16];
 };
 
 /// Wraps an optional const reference to a `Value`.
@@ -304,6 +620,18 @@ public:
 		return maybe_value_->get().property(key);
 	}
 
+	/// Like `property(std::string_view)`, but using a prepared key.
+	[[nodiscard]]
+	auto property(KeyHandle const& handle) const noexcept
+		-> MaybeValueReference
+	{
+		if (!exists())
+		{
+			return MaybeValueReference::empty();
+		}
+		return maybe_value_->get().property(handle);
+	}
+
 	/** Attempt to get the value associated with an index in a list.
 	 *
 	 * If no reference is contained, return an empty `MaybeValueReference`.
@@ -347,7 +675,7 @@ public:
 	 * does exist but is not a string, throw `std::bad_variant_access`.
 	 */
 	[[nodiscard]]
-	auto as_string(void) const -> std::string const&
+	auto as_string(void) const -> std::string_view
 	{
 		return as_value().as_string();
 	}
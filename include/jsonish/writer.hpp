@@ -0,0 +1,139 @@
+#ifndef JSH_WRITER_HPP_INCLUDED
+#define JSH_WRITER_HPP_INCLUDED
+
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace jsonish
+{
+/** Writes a jsonish document piece by piece, without building a tree.
+ *
+ * A writer either collects its output in a buffer, obtained with `output`,
+ * or writes it to a file descriptor in large chunks. Strings too long to be
+ * worth copying into the chunk are written straight from the caller's
+ * memory along with it, with a single scatter-gather write.
+ *
+ * The writer checks that calls form exactly one value: keys only as the next
+ * item of an object, every key followed by a value, containers closed in the
+ * order they were opened, and nothing after the top-level value is done.
+ * A call that breaks these rules throws `std::logic_error` and writes
+ * nothing. Failing to write to a file descriptor throws `std::system_error`.
+ *
+ * Output is compact, with no whitespace between tokens.
+ */
+class Writer
+{
+public:
+	/// The default size of the chunks written to a file descriptor.
+	static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+	/// Construct a writer that collects its output in a buffer.
+	Writer(void) = default;
+
+	/** Construct a writer that writes to a file descriptor.
+	 *
+	 * The descriptor is not closed by the writer. Output is written once
+	 * `chunk_size` bytes are pending, by `flush`, and when the top-level
+	 * value is done.
+	 */
+	explicit
+	Writer(int fd, std::size_t chunk_size = default_chunk_size);
+
+	Writer(Writer&&) noexcept = default;
+	Writer& operator=(Writer&&) noexcept = default;
+
+	/// Write any pending output, ignoring errors.
+	~Writer(void);
+
+	Writer& begin_object(void);
+	Writer& end_object(void);
+
+	Writer& begin_list(void);
+	Writer& end_list(void);
+
+	/// Write the key of the next member of the innermost object.
+	Writer& key(std::string_view key);
+
+	/// Write a string value.
+	Writer& string(std::string_view str);
+
+	/// Write a whole value, with the members of objects in key order.
+	Writer& value(Value const& value);
+
+	/// Write any pending output to the file descriptor, if there is one.
+	void flush(void);
+
+	/// Get the number of containers that are open.
+	[[nodiscard]]
+	std::size_t depth(void) const noexcept { return open_.size(); }
+
+	/// Indicate whether a whole top-level value has been written.
+	[[nodiscard]]
+	bool is_done(void) const noexcept { return done_; }
+
+	/** Get the output collected so far.
+	 *
+	 * For a writer with a file descriptor, this is only the output that
+	 * has yet to be written.
+	 */
+	[[nodiscard]]
+	std::string_view output(void) const noexcept { return buffer_; }
+
+	/// Take the collected output, leaving the buffer empty.
+	[[nodiscard]]
+	std::string take_output(void) noexcept;
+
+private:
+	enum struct Container : std::uint8_t
+	{
+		object,
+		list
+	};
+
+	// Check that a value may be written here and write any ',' before it.
+	void begin_value(void);
+
+	// Note that a value was finished, which may finish the document.
+	void end_value(void);
+
+	void end_container(Container container);
+
+	// Write a quoted string with any characters escaped.
+	void write_string(std::string_view str);
+
+	void write(char c);
+	void write(std::string_view chars);
+
+	// Write the pending output followed by `chars`, emptying the buffer.
+	void write_out(std::string_view chars);
+
+	// Write to `fd_`, or -1 to collect output in `buffer_`.
+	int fd_ = -1;
+
+	std::size_t chunk_size_ = default_chunk_size;
+
+	// Output that is collected, or pending for `fd_`.
+	std::string buffer_;
+
+	// The containers that are open, innermost last.
+	std::vector<Container> open_;
+
+	// Whether the innermost container has no items yet.
+	bool at_first_item_ = true;
+
+	/*
+	 * Whether the innermost container is an object whose last key has no
+	 * value yet.
+	 */
+	bool after_key_ = false;
+
+	bool done_ = false;
+};
+} // namespace jsonish
+
+#endif
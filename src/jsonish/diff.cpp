@@ -0,0 +1,306 @@
+#include "jsonish/diff.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace jsonish
+{
+static
+void diff_values(Value const& from, Value const& to, Path& path, Patch& patch);
+
+// Walk the sorted members of both objects together.
+static
+void diff_objects(
+	Object const& from, Object const& to, Path& path, Patch& patch)
+{
+	auto a = std::begin(from);
+	auto b = std::begin(to);
+	while (a != std::end(from) || b != std::end(to))
+	{
+		if (b == std::end(to) || (a != std::end(from) && a->first < b->first))
+		{
+			path.emplace_back(a->first);
+			patch.push_back(Change{ChangeKind::removed, path, Value()});
+			path.pop_back();
+			++a;
+		}
+		else if (a == std::end(from) || b->first < a->first)
+		{
+			path.emplace_back(b->first);
+			patch.push_back(Change{ChangeKind::added, path, b->second});
+			path.pop_back();
+			++b;
+		}
+		else
+		{
+			path.emplace_back(a->first);
+			diff_values(a->second, b->second, path, patch);
+			path.pop_back();
+			++a;
+			++b;
+		}
+	}
+}
+
+static
+void diff_lists(List const& from, List const& to, Path& path, Patch& patch)
+{
+	auto const common = std::min(from.size(), to.size());
+	auto a = std::begin(from);
+	auto b = std::begin(to);
+	for (std::size_t i = 0; i < common; ++i, ++a, ++b)
+	{
+		path.emplace_back(i);
+		diff_values(*a, *b, path, patch);
+		path.pop_back();
+	}
+
+	// Removing from the back keeps the indices of later removals valid.
+	for (auto i = from.size(); i > common; --i)
+	{
+		path.emplace_back(i - 1);
+		patch.push_back(Change{ChangeKind::removed, path, Value()});
+		path.pop_back();
+	}
+	for (; b != std::end(to); ++b)
+	{
+		path.emplace_back(static_cast<std::size_t>(
+			std::distance(std::begin(to), b)));
+		patch.push_back(Change{ChangeKind::added, path, *b});
+		path.pop_back();
+	}
+}
+
+static
+void diff_values(Value const& from, Value const& to, Path& path, Patch& patch)
+{
+	if (from.shares_storage_with(to))
+	{
+		return;
+	}
+	if (from.is_object() && to.is_object())
+	{
+		diff_objects(from.as_object(), to.as_object(), path, patch);
+		return;
+	}
+	if (from.is_list() && to.is_list())
+	{
+		diff_lists(from.as_list(), to.as_list(), path, patch);
+		return;
+	}
+	if (from.is_string() && to.is_string()
+		&& from.as_string() == to.as_string())
+	{
+		return;
+	}
+	patch.push_back(Change{ChangeKind::changed, path, to});
+}
+
+[[nodiscard]]
+Patch diff(Value const& from, Value const& to)
+{
+	Patch patch;
+	Path path;
+	diff_values(from, to, path, patch);
+	return patch;
+}
+
+using ChangeIterator = Patch::const_iterator;
+
+[[noreturn]]
+static
+void fail_to_apply(void)
+{
+	throw std::invalid_argument("patch does not apply to value");
+}
+
+[[nodiscard]]
+static
+Value apply_in(
+	Value const& value,
+	ChangeIterator first,
+	ChangeIterator last,
+	std::size_t depth);
+
+/*
+ * Find the end of the run of changes starting at `first` that lie below the
+ * same member or element, or `first` if it is for the member or element
+ * itself.
+ */
+[[nodiscard]]
+static
+ChangeIterator end_of_run(
+	ChangeIterator first, ChangeIterator last, std::size_t depth)
+{
+	auto const below = [&](Change const& change)
+	{
+		return change.path.size() > depth + 1
+			&& change.path[depth] == first->path[depth];
+	};
+	return below(*first) ? std::find_if_not(first, last, below) : first;
+}
+
+// Make changes to an object, all of which lie inside it.
+[[nodiscard]]
+static
+Value apply_to_object(
+	Object object, ChangeIterator first, ChangeIterator last, std::size_t depth)
+{
+	while (first != last)
+	{
+		auto const* key = std::get_if<std::string>(&first->path[depth]);
+		if (!key)
+		{
+			fail_to_apply();
+		}
+
+		auto const run_end = end_of_run(first, last, depth);
+		if (run_end != first)
+		{
+			auto const child = object.property(*key);
+			if (!child.exists())
+			{
+				fail_to_apply();
+			}
+			object.set_property(
+				*key, apply_in(child.as_value(), first, run_end, depth + 1));
+			first = run_end;
+			continue;
+		}
+
+		switch (first->kind)
+		{
+		case ChangeKind::added:
+			if (!object.try_insert(*key, first->value))
+			{
+				fail_to_apply();
+			}
+			break;
+		case ChangeKind::removed:
+			if (!object.erase(*key))
+			{
+				fail_to_apply();
+			}
+			break;
+		case ChangeKind::changed:
+			if (!object.property(*key).exists())
+			{
+				fail_to_apply();
+			}
+			object.set_property(*key, first->value);
+			break;
+		default:
+			fail_to_apply();
+		}
+		++first;
+	}
+	return Value(std::move(object));
+}
+
+// Make changes to the elements of a list, all of which lie inside it.
+[[nodiscard]]
+static
+Value apply_to_list(
+	std::vector<Value> elements,
+	ChangeIterator first,
+	ChangeIterator last,
+	std::size_t depth)
+{
+	while (first != last)
+	{
+		auto const* index = std::get_if<std::size_t>(&first->path[depth]);
+		if (!index || *index > elements.size())
+		{
+			fail_to_apply();
+		}
+		auto const position =
+			std::begin(elements) + static_cast<std::ptrdiff_t>(*index);
+
+		auto const run_end = end_of_run(first, last, depth);
+		if (run_end != first)
+		{
+			if (*index == elements.size())
+			{
+				fail_to_apply();
+			}
+			*position = apply_in(*position, first, run_end, depth + 1);
+			first = run_end;
+			continue;
+		}
+
+		if (first->kind == ChangeKind::added)
+		{
+			elements.insert(position, first->value);
+		}
+		else if (*index == elements.size())
+		{
+			fail_to_apply();
+		}
+		else if (first->kind == ChangeKind::removed)
+		{
+			elements.erase(position);
+		}
+		else
+		{
+			*position = first->value;
+		}
+		++first;
+	}
+	return Value(List(std::move(elements)));
+}
+
+/*
+ * Make changes whose paths all have more than `depth` elements to `value`,
+ * copying it once.
+ */
+[[nodiscard]]
+static
+Value apply_in(
+	Value const& value,
+	ChangeIterator first,
+	ChangeIterator last,
+	std::size_t depth)
+{
+	if (value.is_object())
+	{
+		return apply_to_object(value.as_object(), first, last, depth);
+	}
+	if (value.is_list())
+	{
+		auto const& list = value.as_list();
+		return apply_to_list(
+			std::vector<Value>(std::begin(list), std::end(list)),
+			first, last, depth);
+	}
+	fail_to_apply();
+}
+
+[[nodiscard]]
+Value apply(Patch const& patch, Value const& value)
+{
+	auto result = value;
+	auto first = std::cbegin(patch);
+	while (first != std::cend(patch))
+	{
+		if (first->path.empty())
+		{
+			if (first->kind != ChangeKind::changed)
+			{
+				fail_to_apply();
+			}
+			result = first->value;
+			++first;
+			continue;
+		}
+
+		auto const last = std::find_if(
+			first, std::cend(patch),
+			[](Change const& change) { return change.path.empty(); });
+		result = apply_in(result, first, last, 0);
+		first = last;
+	}
+	return result;
+}
+} // namespace jsonish
@@ -0,0 +1,222 @@
+#include "jsonish/document.hpp"
+
+#include "jsonish/lex.hpp"
+#include "jsonish/parse_value.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace jsonish
+{
+// Make the offsets of the spans inside `span` relative to it.
+static
+void make_relative(detail::Span& span)
+{
+	for (auto& child : span.children)
+	{
+		make_relative(child);
+		child.offset -= span.offset;
+	}
+}
+
+/*
+ * Parse `chars`, which start at `base` in the text, as a whole value and
+ * record its span.
+ */
+[[nodiscard]]
+static
+std::optional<detail::Span> parse_spanned(
+	std::string_view chars,
+	std::size_t base,
+	ParseOptions const& options,
+	Result<Value>& result)
+{
+	SpanRecorder spans;
+	spans.base = base;
+	ParseScratch scratch;
+	scratch.spans = &spans;
+
+	Lexer lex(chars, options);
+	result = parse_document(lex, scratch);
+	if (!result.is_valid() || result.value().is_string())
+	{
+		return std::nullopt;
+	}
+	make_relative(spans.root);
+	return std::move(spans.root);
+}
+
+Document::Document(std::string text, ParseOptions const& options) :
+	options_(options), text_(std::move(text))
+{
+	parse_all();
+}
+
+bool Document::parse_all(void)
+{
+	last_parsed_size_ = text_.size();
+
+	Result<Value> result(Value{});
+	auto span = parse_spanned(text_, 0, options_, result);
+	if (!result.is_valid())
+	{
+		errors_ = std::move(result).errors();
+		return false;
+	}
+
+	errors_.clear();
+	value_ = std::move(result).value();
+	span_ = span ? std::move(*span) : detail::Span{};
+	return true;
+}
+
+// Get the value inside a container at the place a span was recorded.
+[[nodiscard]]
+static
+Value const& child_value(Value const& container, detail::Span const& span)
+{
+	if (container.is_object())
+	{
+		return container.property(span.key).as_value();
+	}
+	return container.at(span.index).as_value();
+}
+
+// Copy a container, with the value at the place of `span` replaced.
+[[nodiscard]]
+static
+Value with_child(
+	Value const& container, detail::Span const& span, Value child)
+{
+	if (container.is_object())
+	{
+		auto object = container.as_object();
+		object.set_property(span.key, std::move(child));
+		return Value(std::move(object));
+	}
+	auto list = container.as_list();
+	*std::next(std::begin(list), static_cast<std::ptrdiff_t>(span.index)) =
+		std::move(child);
+	return Value(std::move(list));
+}
+
+bool Document::edit(
+	std::size_t offset, std::size_t removed, std::string_view inserted)
+{
+	if (offset > text_.size() || removed > text_.size() - offset)
+	{
+		throw std::out_of_range("jsonish::Document::edit");
+	}
+	text_.replace(offset, removed, inserted);
+
+	// Without a tree of spans matching the old text, start from scratch.
+	if (!is_valid() || value_.is_string())
+	{
+		return parse_all();
+	}
+
+	/*
+	 * Find the containers that strictly contain the edit, leaving their
+	 * opening and closing characters untouched, from the outermost in.
+	 */
+	std::vector<detail::Span*> path;
+	std::vector<std::size_t> starts;
+	auto const contains = [&](std::size_t start, detail::Span const& span)
+	{
+		return start < offset && offset + removed < start + span.length;
+	};
+	if (contains(span_.offset, span_))
+	{
+		path.push_back(&span_);
+		starts.push_back(span_.offset);
+	}
+	while (!path.empty())
+	{
+		auto& children = path.back()->children;
+		auto const parent_start = starts.back();
+
+		// The last child starting before the edit is the only candidate.
+		auto const after = std::upper_bound(
+			std::begin(children), std::end(children), offset - parent_start,
+			[](std::size_t relative, detail::Span const& child)
+			{
+				return relative < child.offset;
+			});
+		if (after == std::begin(children))
+		{
+			break;
+		}
+		auto& child = *std::prev(after);
+		auto const start = parent_start + child.offset;
+		if (!contains(start, child))
+		{
+			break;
+		}
+		path.push_back(&child);
+		starts.push_back(start);
+	}
+
+	// Parse the innermost container that is still a value by itself.
+	auto const grown = inserted.size() >= removed;
+	auto const change =
+		grown ? inserted.size() - removed : removed - inserted.size();
+	while (!path.empty())
+	{
+		auto& span = *path.back();
+		auto const start = starts.back();
+		auto const length =
+			grown ? span.length + change : span.length - change;
+
+		Result<Value> result(Value{});
+		auto replacement = parse_spanned(
+			std::string_view(text_).substr(start, length),
+			start, options_, result);
+		if (!replacement)
+		{
+			path.pop_back();
+			starts.pop_back();
+			continue;
+		}
+		last_parsed_size_ = length;
+
+		// Copy the containers around the new value, from the inside out.
+		std::vector<Value const*> values{&value_};
+		for (std::size_t i = 1; i < path.size(); ++i)
+		{
+			values.push_back(&child_value(*values.back(), *path[i]));
+		}
+		auto value = std::move(result).value();
+		for (auto i = path.size() - 1; i > 0; --i)
+		{
+			value = with_child(*values[i - 1], *path[i], std::move(value));
+		}
+		value_ = std::move(value);
+
+		// Later spans in the enclosing containers move with the edit.
+		replacement->offset = span.offset;
+		replacement->index = span.index;
+		replacement->key = std::move(span.key);
+		span = std::move(*replacement);
+		for (std::size_t i = 0; i + 1 < path.size(); ++i)
+		{
+			auto& enclosing = *path[i];
+			enclosing.length =
+				grown ? enclosing.length + change : enclosing.length - change;
+			for (auto& child : enclosing.children)
+			{
+				if (child.offset > path[i + 1]->offset)
+				{
+					child.offset =
+						grown ? child.offset + change : child.offset - change;
+				}
+			}
+		}
+		return true;
+	}
+
+	return parse_all();
+}
+} // namespace jsonish
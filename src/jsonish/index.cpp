@@ -0,0 +1,155 @@
+#include "jsonish/index.hpp"
+
+#include "jsonish/detail/hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace jsonish
+{
+// Elements are split into chunks of this many for threads to take in turn.
+static constexpr std::size_t chunk_size = 4096;
+
+Index::Index(Value list, Path path, std::size_t thread_count) :
+	value_(std::move(list)), path_(std::move(path))
+{
+	if (!value_.is_list())
+	{
+		throw std::invalid_argument("only a list can be indexed");
+	}
+	list_ = &value_.as_list();
+
+	auto const count = list_->size();
+	if (count >= std::numeric_limits<std::uint32_t>::max())
+	{
+		throw std::length_error("list is too long to index");
+	}
+	keys_.resize(count);
+	hashes_.resize(count);
+
+	/*
+	 * Finding and hashing the keys is most of the work, and is done in
+	 * chunks by several threads. Filling the table is left to one thread.
+	 */
+	if (thread_count == 0)
+	{
+		thread_count = std::max(
+			std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+	}
+	auto const chunk_count = (count + chunk_size - 1) / chunk_size;
+	thread_count =
+		std::max(std::min(thread_count, chunk_count), std::size_t{1});
+
+	std::atomic<std::size_t> next{0};
+	auto const work = [&]() noexcept
+	{
+		auto i = next.fetch_add(1, std::memory_order_relaxed);
+		for (; i < chunk_count;
+			i = next.fetch_add(1, std::memory_order_relaxed))
+		{
+			read_keys(i * chunk_size, std::min((i + 1) * chunk_size, count));
+		}
+	};
+
+	// The calling thread does its share of the work too.
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	try
+	{
+		for (std::size_t i = 1; i < thread_count; ++i)
+		{
+			threads.emplace_back(work);
+		}
+	}
+	catch (...)
+	{
+		// Carry on with the threads that did start.
+	}
+	work();
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::size_t slot_count = 2;
+	while (slot_count < 2 * count)
+	{
+		slot_count *= 2;
+	}
+	slots_.resize(slot_count);
+
+	auto const mask = slots_.size() - 1;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!keys_[i])
+		{
+			continue;
+		}
+
+		// Leave the slot to an earlier element with the same key.
+		auto slot = detail::mix_hash(hashes_[i]) & mask;
+		while (slots_[slot] != 0
+			&& (hashes_[slots_[slot] - 1] != hashes_[i]
+				|| keys_[slots_[slot] - 1] != keys_[i]))
+		{
+			slot = (slot + 1) & mask;
+		}
+		if (slots_[slot] == 0)
+		{
+			slots_[slot] = static_cast<std::uint32_t>(i + 1);
+			++size_;
+		}
+	}
+}
+
+void Index::read_keys(std::size_t first, std::size_t last) noexcept
+{
+	auto element = std::next(
+		std::begin(*list_), static_cast<std::ptrdiff_t>(first));
+	for (auto i = first; i < last; ++i, ++element)
+	{
+		auto const key = find_path(*element, path_);
+		if (key.exists() && key.as_value().is_string())
+		{
+			keys_[i] = key.as_value().as_string();
+			hashes_[i] = detail::hash_key(*keys_[i]);
+		}
+	}
+}
+
+[[nodiscard]]
+auto Index::find(std::string_view key) const noexcept -> MaybeValueReference
+{
+	auto const found = position(key);
+	if (!found)
+	{
+		return MaybeValueReference::empty();
+	}
+	return list_->at(*found);
+}
+
+[[nodiscard]]
+std::optional<std::size_t> Index::position(
+	std::string_view key) const noexcept
+{
+	auto const hash = detail::hash_key(key);
+	auto const mask = slots_.size() - 1;
+	for (auto slot = detail::mix_hash(hash) & mask;; slot = (slot + 1) & mask)
+	{
+		if (slots_[slot] == 0)
+		{
+			return std::nullopt;
+		}
+
+		auto const index = std::size_t{slots_[slot] - 1};
+		if (hashes_[index] == hash && *keys_[index] == key)
+		{
+			return index;
+		}
+	}
+}
+} // namespace jsonish
@@ -1,67 +1,71 @@
 #include "jsonish/lex.hpp"
 
+#include "jsonish/detail/chars.hpp"
+#include "jsonish/unescape.hpp"
+
 #include <algorithm>
 #include <cassert>
-#include <charconv>
-#include <locale>
+#include <utility>
 
 namespace jsonish
 {
-[[nodiscard]] static constexpr
-bool is_space(char c) noexcept
+Token Lexer::extract_token(void)
 {
-	switch (c)
+	if (cache_.has_value())
 	{
-	case ' ': case '\t': case '\n': case '\r':
-		return true;
-	default:
-		return false;
+		return *std::exchange(cache_, std::nullopt);
 	}
+	return extract_token_from_source();
 }
 
-[[nodiscard]] static
-bool is_hex_digit(char c) noexcept
-{
-	return std::isxdigit(c, std::locale::classic());
-}
-
-// This character can follow a backslash in a string.
-[[nodiscard]] static constexpr
-bool is_escapable(char c) noexcept
+Token Lexer::skip_token(void)
 {
-	switch (c)
+	if (cache_.has_value())
 	{
-	case '"': case '\\': case '/':
-	case 'b': case 'f': case 'n': case 'r': case 't': case 'u':
-		return true;
-	default:
-		return false;
+		return *std::exchange(cache_, std::nullopt);
+	}
+	if (reader_ != nullptr)
+	{
+		return extract_pulled_token(false);
 	}
-}
 
-// This character is not allowed at all in a string.
-[[nodiscard]] static constexpr
-bool is_disallowed_in_string(char c) noexcept
-{
-	return c < 0x20;
-}
+	extract_leading_whitespace();
+	if (at_end() || peek_char() != '"')
+	{
+		return extract_token_from_source();
+	}
 
-Token Lexer::extract_token(void)
-{
-	if (cache_.has_value())
+	auto const tok_start = source_;
+	++source_.offset;
+	bool has_escapes = false;
+	auto const result = scan_string(
+		source_.chars.substr(source_.offset),
+		options_.validate_utf8,
+		has_escapes);
+	source_.offset += result.consumed;
+
+	if (result.error.has_value())
 	{
-		return *std::exchange(cache_, std::nullopt);
+		return Token::invalid(tok_start, *result.error);
 	}
-	return extract_token_from_source();
+	return Token::string(tok_start, std::string());
 }
 
-Token Lexer::peek_token(void)
+Token const& Lexer::peek_token(void)
 {
 	cache_next_token();
 	assert(cache_.has_value());
 	return *cache_;
 }
 
+[[nodiscard]]
+SourcePosition Lexer::peek_position(void)
+{
+	cache_next_token();
+	assert(cache_.has_value());
+	return cache_->position();
+}
+
 [[nodiscard]]
 bool Lexer::next_is(TokenType type)
 {
@@ -87,9 +91,20 @@ bool Lexer::at_end(void) const noexcept
 
 void Lexer::extract_leading_whitespace(void) noexcept
 {
+	// The padding is not whitespace, so it stops the scan.
+	if (padded_)
+	{
+		auto const* const data = source_.chars.data();
+		while (detail::is_space(data[source_.offset]))
+		{
+			++source_.offset;
+		}
+		return;
+	}
+
 	auto first = std::cbegin(source_.chars) + source_.offset;
 	auto last = std::cend(source_.chars);
-	auto after_whitespace = std::find_if_not(first, last, is_space);
+	auto after_whitespace = std::find_if_not(first, last, detail::is_space);
 
 	source_.offset += static_cast<std::size_t>(
 		std::distance(first, after_whitespace));
@@ -109,96 +124,6 @@ char Lexer::extract_char(void) noexcept
 	return c;
 }
 
-/*
- * Map an escaped character to the character it represents. For example, 'n' is
- * mapped to a newline character and a backslash is mapped to itself. If the
- * character is not escapable by itself, it is mapped to a null character. It
- * is expected that this never be the case.
- */
-[[nodiscard]] static constexpr
-char map_escaped_char(char c) noexcept
-{
-	assert(is_escapable(c) && c != 'u');
-
-	switch (c)
-	{
-	case '"': return '"';
-	case '\\': return '\\';
-	case '/': return '/';
-	case 'b': return '\b';
-	case 'f': return '\f';
-	case 'n': return '\n';
-	case 'r': return '\r';
-	case 't': return '\t';
-	default: return '\0';
-	}
-}
-
-/*
- * Parse the hex digits of a four-digit hex unicode code point into a number.
- * No validation is done, so a valid value must be provided. If parsing fails,
- * 0 will just be returned.
- *
- * The input must be exactly four digits. This guarantees that it fits in 16
- * bits.
- */
-[[nodiscard]] static
-std::uint16_t parse_code_point(std::string_view str)
-{
-	assert(str.size() == 4);
-
-	std::uint16_t result;
-	auto [last, err] = std::from_chars(str.data(), str.data() + 4, result, 16);
-
-	if (err != std::errc{} || last != str.data() + 4)
-	{
-		return 0;
-	}
-
-	return result;
-}
-
-/*
- * Get, from `value`, the range of bits [first, first + n). This starts from
- * the least significant bit, which is considered to have index 0.
- *
- * The result has the bottom `n` digits set to the range and the rest set to
- * zero. `n` absolutely must be less than or equal to 8.
- */
-[[nodiscard]] static constexpr
-char get_bit_range(
-	std::uint16_t value, std::size_t first, std::size_t n) noexcept
-{
-	assert(n <= 8 && first < sizeof(value) * 8);
-	return (value >> first) & ((1 << n) - 1);
-}
-
-/*
- * Push the four-character unicode code point `code_point` into `str` as utf-8.
- * Invalid code points are just treated as if they are valid.
- */
-static
-void push_unicode_as_utf8(std::string& str, std::uint16_t code_point)
-{
-	if (code_point < 0x0080)
-	{
-		str.push_back(static_cast<char>(code_point));
-		return;
-	}
-
-	// Base of trailing byte for any multibyte character.
-	constexpr unsigned char trailing_byte = 0b10000000;
-	if (code_point < 0x0800)
-	{
-		str.push_back(0b11000000 | get_bit_range(code_point, 6, 5));
-		str.push_back(trailing_byte | get_bit_range(code_point, 0, 6));
-		return;
-	}
-	str.push_back(0b11100000 | get_bit_range(code_point, 12, 4));
-	str.push_back(trailing_byte | get_bit_range(code_point, 6, 6));
-	str.push_back(trailing_byte | get_bit_range(code_point, 0, 6));
-}
-
 void Lexer::cache_next_token(void)
 {
 	if (cache_.has_value())
@@ -210,6 +135,11 @@ void Lexer::cache_next_token(void)
 
 Token Lexer::extract_token_from_source(void)
 {
+	if (reader_ != nullptr)
+	{
+		return extract_pulled_token(true);
+	}
+
 	extract_leading_whitespace();
 	auto tok_start = source_;
 
@@ -227,82 +157,57 @@ Token Lexer::extract_token_from_source(void)
 	case ']': return Token::rbracket(tok_start);
 	case ',': return Token::comma(tok_start);
 	case ':': return Token::colon(tok_start);
-	default: return Token::invalid(tok_start, "unexpected character");
+	default: return Token::invalid(tok_start, ErrorCode::unexpected_character);
 	}
 }
 
-Token Lexer::extract_string(SourcePosition tok_start)
+Token Lexer::extract_pulled_token(bool keep_text)
 {
-	assert(source_.offset > 0 && source_.chars[source_.offset - 1] == '"');
-
-	// TODO Can this be reserved upfront somewhere instead?
-	std::string text;
-
-	bool in_escape = false;
-	// Number of digits yet to be processed in a unicode code point.
-	int remaining_code_point_digits = 0;
-	while (true)
+	if (!reader_->next())
 	{
-		if (at_end())
+		if (auto const& error = reader_->error())
 		{
-			return Token::invalid(tok_start, "no closing quote");
+			return Token::invalid(error->position, error->code);
 		}
+		return Token::eof(SourcePosition{{}, reader_->offset()});
+	}
 
-		char c = extract_char();
-		if (remaining_code_point_digits > 0)
-		{
-			assert(remaining_code_point_digits <= 4);
-
-			if (!is_hex_digit(c))
-			{
-				return Token::invalid(
-					tok_start, "expected a hex digit");
-			}
-			if (remaining_code_point_digits == 1)
-			{
-				auto code_point_name =
-					source_.chars.substr(source_.offset - 4, 4);
-				std::uint16_t code_point_hex =
-					parse_code_point(code_point_name);
-				push_unicode_as_utf8(text, code_point_hex);
-			}
-			--remaining_code_point_digits;
-		}
-		else if (in_escape)
-		{
-			if (!is_escapable(c))
-			{
-				return Token::invalid(
-					tok_start, "invalid escape sequence");
-			}
-			if (c == 'u')
-			{
-				remaining_code_point_digits = 4;
-				in_escape = false;
-				continue;
-			}
-			text.push_back(map_escaped_char(c));
-			in_escape = false;
-		}
-		else if (c == '"')
-		{
-			break;
-		}
-		else if (c == '\\')
-		{
-			in_escape = true;
-		}
-		else if (is_disallowed_in_string(c))
-		{
-			return Token::invalid(
-				tok_start, "invalid character in string");
-		}
-		else
-		{
-			text.push_back(c);
-		}
+	SourcePosition const tok_start{{}, reader_->offset()};
+	switch (reader_->kind())
+	{
+	case TokenKind::string:
+		return Token::string(
+			tok_start,
+			keep_text ? std::string(reader_->text()) : std::string());
+	case TokenKind::lbrace: return Token::lbrace(tok_start);
+	case TokenKind::rbrace: return Token::rbrace(tok_start);
+	case TokenKind::lbracket: return Token::lbracket(tok_start);
+	case TokenKind::rbracket: return Token::rbracket(tok_start);
+	case TokenKind::comma: return Token::comma(tok_start);
+	case TokenKind::colon: return Token::colon(tok_start);
+	default: return Token::invalid(tok_start, ErrorCode::unexpected_character);
 	}
+}
+
+Token Lexer::extract_string(SourcePosition tok_start)
+{
+	assert(source_.offset > 0 && source_.chars[source_.offset - 1] == '"');
+
+	static_assert(PaddedString::padding >= unescape_padding);
 
-	return Token::string(tok_start, text);
+	std::string text;
+	auto const chars = source_.chars.substr(source_.offset);
+	auto const max_length = options_.limits.max_string_length;
+	auto const result = padded_
+		? unescape_padded_string(
+			chars, text, options_.validate_utf8, max_length)
+		: unescape_string(chars, text, options_.validate_utf8, max_length);
+	source_.offset += result.consumed;
+
+	if (result.error.has_value())
+	{
+		return Token::invalid(tok_start, *result.error);
+	}
+	return Token::string(tok_start, std::move(text));
 }
 } // namespace jsonish
@@ -1,6 +1,10 @@
 #ifndef JSH_LEX_HPP_INCLUDED
 #define JSH_LEX_HPP_INCLUDED
 
+#include "jsonish/padded_string.hpp"
+#include "jsonish/parse_options.hpp"
+#include "jsonish/pull_reader.hpp"
+#include "jsonish/result.hpp"
 #include "jsonish/source_position.hpp"
 
 #include <cassert>
@@ -37,11 +41,13 @@ public:
 		return Token(pos, TokenType::eof);
 	}
 
-	/// Create an invalid token with a reason.
+	/// Create an invalid token with the reason it is invalid.
 	[[nodiscard]] static
-	Token invalid(SourcePosition pos, std::string reason)
+	Token invalid(SourcePosition pos, ErrorCode error) noexcept
 	{
-		return Token(pos, TokenType::invalid, std::move(reason));
+		auto token = Token(pos, TokenType::invalid);
+		token.error_ = error;
+		return token;
 	}
 
 	/// Create a string token.
@@ -102,7 +108,15 @@ public:
 	/// Get the type of this token.
 	TokenType type(void) const noexcept { return type_; }
 
-	/// Get the text stored in an invalid or string token.
+	/// Get the reason an invalid token is invalid.
+	[[nodiscard]]
+	ErrorCode error(void) const noexcept
+	{
+		assert(type_ == TokenType::invalid);
+		return error_;
+	}
+
+	/// Get the text stored in a string token.
 	std::string_view text(void) const&
 	{
 		assert(value_.has_value());
@@ -123,20 +137,22 @@ public:
 private:
 	// Construct a token with no stored value.
 	Token(SourcePosition pos, TokenType type) noexcept :
-		type_(type), value_(std::nullopt), pos_(pos)
+		type_(type), error_(), value_(std::nullopt), pos_(pos)
 	{}
 
 	// Construct a token with a stored value.
 	Token(SourcePosition pos, TokenType type, std::string value) :
-		type_(type), value_(std::move(value)), pos_(pos)
+		type_(type), error_(), value_(std::move(value)), pos_(pos)
 	{}
 
 	TokenType type_;
 
-	/** The value of a string or invalid token
+	// The reason an invalid token is invalid. Meaningless for other types.
+	ErrorCode error_;
+
+	/** The value of a string token
 	 *
-	 * This will only exist for a string token, containing its text, or for
-	 * an invalid token, containing the reason it is invalid.
+	 * This will only exist for a string token, containing its text.
 	 */
 	std::optional<std::string> value_;
 
@@ -150,10 +166,39 @@ public:
 	/** Construct a lexer with a sequence of characters.
 	 *
 	 * @param chars the sequence of input characters
+	 * @param options controls how strings are checked, and is available
+	 * to parsers through `options`
+	 */
+	explicit
+	Lexer(
+		std::string_view chars,
+		ParseOptions const& options = {}) noexcept :
+		source_{chars, 0}, options_(options)
+	{}
+
+	/** Construct a lexer over padded characters.
+	 *
+	 * The padding lets whitespace and strings be scanned without checking
+	 * for the end on every character. `chars` must outlive the lexer. A
+	 * moved-from string has no padding, so it is lexed as an empty view.
+	 */
+	explicit
+	Lexer(
+		PaddedString const& chars,
+		ParseOptions const& options = {}) noexcept :
+		source_{chars.view(), 0},
+		options_(options),
+		padded_(chars.data() != nullptr)
+	{}
+
+	/** Construct a lexer over the tokens of a `PullReader`.
+	 *
+	 * Only part of the input is held at a time, so `chars` is empty, and
+	 * positions only have offsets. `reader` must outlive the lexer.
 	 */
 	explicit
-	Lexer(std::string_view chars) noexcept :
-		source_{chars, 0}
+	Lexer(PullReader& reader) noexcept :
+		source_{{}, 0}, options_(reader.options()), reader_(&reader)
 	{}
 
 	Lexer(Lexer const&) noexcept = default;
@@ -164,9 +209,24 @@ public:
 	/// Remove the next token and return it.
 	Token extract_token(void);
 
-	/// Get the next token without removing it.
+	/** Remove the next token, without decoding it if it is a string.
+	 *
+	 * A string is checked as by `extract_token`, but its text is left
+	 * empty, so nothing is allocated for it. This is for values that are
+	 * only being validated.
+	 */
+	Token skip_token(void);
+
+	/** Get the next token without removing it.
+	 *
+	 * The reference is valid until the token is extracted.
+	 */
+	[[nodiscard]]
+	Token const& peek_token(void);
+
+	/// Get the position of the next token without removing it.
 	[[nodiscard]]
-	Token peek_token(void);
+	SourcePosition peek_position(void);
 
 	/// Indicate whether the next token is of the given type.
 	[[nodiscard]]
@@ -178,6 +238,14 @@ public:
 	 */
 	bool try_extract_token(TokenType type);
 
+	/// Get all of the characters this lexer reads from.
+	[[nodiscard]]
+	std::string_view chars(void) const noexcept { return source_.chars; }
+
+	/// Get the options this lexer was constructed with.
+	[[nodiscard]]
+	ParseOptions const& options(void) const noexcept { return options_; }
+
 private:
 	// True iff no more characters can be read, including whitespace.
 	[[nodiscard]]
@@ -196,6 +264,12 @@ private:
 	// Extract the next token from the source characters, ignoring `cache_`.
 	Token extract_token_from_source(void);
 
+	/*
+	 * Extract the next token from `reader_`, leaving the text of a string
+	 * empty unless `keep_text` is set.
+	 */
+	Token extract_pulled_token(bool keep_text);
+
 	/*
 	 * Extract the end of a string after the leading '"'.
 	 *
@@ -205,6 +279,14 @@ private:
 
 	SourcePosition source_;
 
+	ParseOptions options_;
+
+	// Whether `source_` is followed by the padding of a `PaddedString`.
+	bool padded_ = false;
+
+	// Supplies the tokens instead of `source_`, if set.
+	PullReader* reader_ = nullptr;
+
 	// Keeps track of a peeked token
 	std::optional<Token> cache_;
 };
@@ -0,0 +1,203 @@
+#include "jsonish/merge.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace jsonish
+{
+// Indicate whether `a` can stand in for `b` without anything being lost.
+[[nodiscard]]
+static
+bool is_same(Value const& a, Value const& b)
+{
+	return a.shares_storage_with(b)
+		|| (a.is_string() && b.is_string() && a.as_string() == b.as_string());
+}
+
+/*
+ * Find the first layer that takes part in the merge. A layer that is not an
+ * object replaces everything below it, and is itself replaced by any object
+ * above it.
+ */
+[[nodiscard]]
+static
+std::size_t first_merged_layer(std::vector<Value const*> const& layers)
+{
+	for (auto i = layers.size(); i > 0; --i)
+	{
+		if (!layers[i - 1]->is_object())
+		{
+			return i == layers.size() ? i - 1 : i;
+		}
+	}
+	return 0;
+}
+
+[[nodiscard]]
+static
+Value merge_layers(std::vector<Value const*> layers);
+
+// Merge objects by walking their sorted members together.
+[[nodiscard]]
+static
+Value merge_objects(std::vector<Value const*> const& layers)
+{
+	using Iterator = decltype(std::begin(std::declval<Object const&>()));
+	std::vector<Iterator> heads;
+	std::vector<Iterator> ends;
+	heads.reserve(layers.size());
+	ends.reserve(layers.size());
+	for (auto const* layer : layers)
+	{
+		heads.push_back(std::begin(layer->as_object()));
+		ends.push_back(std::end(layer->as_object()));
+	}
+
+	std::vector<std::pair<std::string, Value>> members;
+	std::vector<Value const*> found;
+	while (true)
+	{
+		std::optional<std::string_view> key;
+		for (std::size_t i = 0; i < layers.size(); ++i)
+		{
+			if (heads[i] != ends[i] && (!key || heads[i]->first < *key))
+			{
+				key = heads[i]->first;
+			}
+		}
+		if (!key)
+		{
+			break;
+		}
+
+		found.clear();
+		for (std::size_t i = 0; i < layers.size(); ++i)
+		{
+			if (heads[i] != ends[i] && heads[i]->first == *key)
+			{
+				found.push_back(&heads[i]->second);
+				++heads[i];
+			}
+		}
+		members.emplace_back(std::string(*key), merge_layers(found));
+	}
+
+	// If one layer already has exactly the merged members, share it.
+	for (auto const* layer : layers)
+	{
+		auto const& object = layer->as_object();
+		if (object.size() == members.size()
+			&& std::equal(
+				std::begin(object), std::end(object), std::begin(members),
+				[](auto const& a, auto const& b)
+				{
+					return a.first == b.first && is_same(a.second, b.second);
+				}))
+		{
+			return *layer;
+		}
+	}
+
+	Object merged;
+	merged.assign(std::move(members));
+	return Value(std::move(merged));
+}
+
+[[nodiscard]]
+static
+Value merge_layers(std::vector<Value const*> layers)
+{
+	layers.erase(
+		std::begin(layers),
+		std::begin(layers)
+			+ static_cast<std::ptrdiff_t>(first_merged_layer(layers)));
+
+	// Layers that share an object add nothing to one another.
+	layers.erase(
+		std::unique(
+			std::begin(layers), std::end(layers),
+			[](Value const* a, Value const* b)
+			{
+				return a->shares_storage_with(*b);
+			}),
+		std::end(layers));
+
+	if (layers.size() == 1)
+	{
+		return *layers.front();
+	}
+	return merge_objects(layers);
+}
+
+[[nodiscard]]
+Value merge(Value const* layers, std::size_t count)
+{
+	if (count == 0)
+	{
+		throw std::invalid_argument("merge needs at least one layer");
+	}
+
+	std::vector<Value const*> pointers;
+	pointers.reserve(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		pointers.push_back(layers + i);
+	}
+	return merge_layers(std::move(pointers));
+}
+
+[[nodiscard]]
+Value Overlay::value(void) const
+{
+	if (layers_.empty())
+	{
+		throw std::bad_optional_access();
+	}
+	return merge(layers_);
+}
+
+[[nodiscard]]
+Overlay Overlay::property(std::string_view key) const
+{
+	/*
+	 * Layers below the last one that is not an object are overridden, and
+	 * that one has no members, so neither is looked at.
+	 */
+	std::vector<Value> found;
+	for (auto layer = std::rbegin(layers_); layer != std::rend(layers_);
+		++layer)
+	{
+		if (!layer->is_object())
+		{
+			break;
+		}
+		auto const value = layer->property(key);
+		if (value.exists())
+		{
+			found.push_back(value.as_value());
+		}
+	}
+	std::reverse(std::begin(found), std::end(found));
+	return Overlay(std::move(found));
+}
+
+[[nodiscard]]
+Overlay Overlay::at(std::size_t index) const
+{
+	std::vector<Value> found;
+	if (!layers_.empty())
+	{
+		auto const value = layers_.back().at(index);
+		if (value.exists())
+		{
+			found.push_back(value.as_value());
+		}
+	}
+	return Overlay(std::move(found));
+}
+} // namespace jsonish
@@ -0,0 +1,40 @@
+#include "jsonish/padded_string.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace jsonish
+{
+PaddedString::PaddedString(std::size_t size) :
+	chars_(new char[size + padding]()), size_(size)
+{}
+
+PaddedString::PaddedString(std::string_view str) : PaddedString(str.size())
+{
+	std::memcpy(chars_.get(), str.data(), str.size());
+}
+
+PaddedString::PaddedString(PaddedString const& other) :
+	PaddedString(other.view())
+{}
+
+PaddedString::PaddedString(PaddedString&& other) noexcept :
+	chars_(std::move(other.chars_)), size_(std::exchange(other.size_, 0))
+{}
+
+PaddedString& PaddedString::operator=(PaddedString const& other)
+{
+	if (this != &other)
+	{
+		*this = PaddedString(other.view());
+	}
+	return *this;
+}
+
+PaddedString& PaddedString::operator=(PaddedString&& other) noexcept
+{
+	chars_ = std::move(other.chars_);
+	size_ = std::exchange(other.size_, 0);
+	return *this;
+}
+} // namespace jsonish
@@ -1,81 +1,339 @@
 #include "jsonish/parse.hpp"
 
 #include "jsonish/lex.hpp"
+#include "jsonish/parse_value.hpp"
+#include "jsonish/projection.hpp"
+#include "jsonish/string_pool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <optional>
 
 namespace jsonish
 {
-// Make an error list with the given error message along with any lexer errors.
-static
-ErrorList make_errors(std::string reason, Token error_token)
+[[nodiscard]]
+ErrorList make_errors(ErrorCode code, Token const& error_token)
 {
-	auto pos = error_token.position();
-
 	ErrorList errors;
-	errors.push_back(Error{std::move(reason), error_token.position()});
+	errors.reserve(2);
+	errors.push_back(Error{code, error_token.position()});
 
 	if (error_token.type() == TokenType::invalid)
 	{
 		errors.push_back(
-			Error{
-				std::move(error_token).text(),
-				error_token.position()
-			});
+			Error{error_token.error(), error_token.position()});
 	}
 
 	return errors;
 }
 
+// Move the items of `stack` from `first` on into a vector of their own.
+template <typename T>
 static
-Result<Value> parse_value(Lexer& lex);
+std::vector<T> pop_items(std::vector<T>& stack, std::size_t first)
+{
+	auto const begin =
+		std::next(std::begin(stack), static_cast<std::ptrdiff_t>(first));
+	std::vector<T> items(
+		std::make_move_iterator(begin),
+		std::make_move_iterator(std::end(stack)));
+	stack.erase(begin, std::end(stack));
+	return items;
+}
 
+// Note where a container ends, given the token closing it.
 static
-Result<List> parse_list(Lexer& lex)
+void close_span(ParseScratch& scratch, Token const& close)
+{
+	if (scratch.spans != nullptr)
+	{
+		scratch.spans->close_container(close.position().offset);
+	}
+}
+
+[[nodiscard]]
+ErrorList make_error(ErrorCode code, SourcePosition position)
+{
+	return ErrorList{Error{code, position}};
+}
+
+/*
+ * Count bytes that the tree will allocate, producing whether the total is
+ * still within its limit.
+ */
+[[nodiscard]]
+static
+bool count_allocation(
+	ParseScratch& scratch, ParseLimits const& limits, std::size_t bytes)
+{
+	scratch.allocated_bytes += bytes;
+	return scratch.allocated_bytes <= limits.max_allocated_bytes;
+}
+
+/*
+ * Count a list or object about to be parsed against the limits, producing
+ * the limit it breaks, if any. Otherwise, it is one level deeper.
+ */
+[[nodiscard]]
+static
+std::optional<ErrorCode> enter_container(
+	ParseScratch& scratch, ParseLimits const& limits, bool is_object)
+{
+	if (scratch.depth >= limits.max_depth)
+	{
+		return ErrorCode::too_deep;
+	}
+	if (++scratch.nodes > limits.max_nodes)
+	{
+		return ErrorCode::too_many_nodes;
+	}
+	auto const node_size = is_object
+		? sizeof(detail::SharedNode<Object>)
+		: sizeof(detail::SharedNode<List>);
+	if (!count_allocation(scratch, limits, node_size))
+	{
+		return ErrorCode::too_much_memory;
+	}
+	++scratch.depth;
+	return std::nullopt;
+}
+
+/*
+ * Check the value at the start of `lex` without building it, producing the
+ * errors found, if any. Strings are scanned without being decoded, and
+ * containers are tracked on `scratch.skipping` rather than by recursion.
+ */
+ErrorList skip_value(Lexer& lex, ParseScratch& scratch)
+{
+	auto& open = scratch.skipping;
+	auto const base = open.size();
+	auto const fail = [&](ErrorCode code, Token const& token)
+	{
+		open.resize(base);
+		return make_errors(code, token);
+	};
+
+	// Read the key of a member and the ':' after it.
+	auto const skip_key = [&]() -> ErrorList
+	{
+		auto key_token = lex.skip_token();
+		if (key_token.type() != TokenType::string)
+		{
+			return fail(ErrorCode::expected_key, key_token);
+		}
+		auto colon_token = lex.skip_token();
+		if (colon_token.type() != TokenType::colon)
+		{
+			return fail(ErrorCode::expected_colon, colon_token);
+		}
+		return {};
+	};
+
+	auto token = lex.skip_token();
+	while (true)
+	{
+		// `token` starts a value.
+		auto const type = token.type();
+		if (type == TokenType::lbrace || type == TokenType::lbracket)
+		{
+			if (scratch.cancellation != nullptr
+				&& scratch.cancellation->is_cancelled())
+			{
+				open.resize(base);
+				return make_error(ErrorCode::cancelled, token.position());
+			}
+			if (scratch.depth + (open.size() - base)
+				>= lex.options().limits.max_depth)
+			{
+				open.resize(base);
+				return make_error(ErrorCode::too_deep, token.position());
+			}
+
+			auto const is_object = type == TokenType::lbrace;
+			auto next = lex.skip_token();
+			if (next.type()
+				!= (is_object ? TokenType::rbrace : TokenType::rbracket))
+			{
+				open.push_back(is_object);
+				if (!is_object)
+				{
+					token = std::move(next);
+					continue;
+				}
+				if (next.type() != TokenType::string)
+				{
+					return fail(ErrorCode::expected_key, next);
+				}
+				auto colon_token = lex.skip_token();
+				if (colon_token.type() != TokenType::colon)
+				{
+					return fail(ErrorCode::expected_colon, colon_token);
+				}
+				token = lex.skip_token();
+				continue;
+			}
+		}
+		else if (type != TokenType::string)
+		{
+			return fail(ErrorCode::expected_value, token);
+		}
+
+		// A value has ended, which may end the containers around it.
+		while (true)
+		{
+			if (open.size() == base)
+			{
+				return {};
+			}
+
+			auto const is_object = open.back();
+			auto next = lex.skip_token();
+			if (next.type() == TokenType::comma)
+			{
+				if (is_object)
+				{
+					auto errors = skip_key();
+					if (!errors.empty())
+					{
+						return errors;
+					}
+				}
+				break;
+			}
+			if (next.type()
+				!= (is_object ? TokenType::rbrace : TokenType::rbracket))
+			{
+				return fail(
+					is_object
+						? ErrorCode::expected_rbrace
+						: ErrorCode::expected_rbracket,
+					next);
+			}
+			open.pop_back();
+		}
+		token = lex.skip_token();
+	}
+}
+
+/*
+ * Parse the next item of the innermost container, whose key or index is
+ * last on `scratch.path`, as the projection selects. A skipped item produces
+ * an empty optional.
+ */
+static
+Result<std::optional<Value>> parse_selected(Lexer& lex, ParseScratch& scratch)
+{
+	using ResultType = Result<std::optional<Value>>;
+
+	auto const* const projection = scratch.projection;
+	auto const selection = projection->select(scratch.path);
+	if (selection == Selection::skip)
+	{
+		auto errors = skip_value(lex, scratch);
+		if (!errors.empty())
+		{
+			return ResultType(std::move(errors));
+		}
+		return ResultType(std::optional<Value>());
+	}
+
+	// Nothing inside a kept value needs to be asked about.
+	if (selection == Selection::keep)
+	{
+		scratch.projection = nullptr;
+	}
+	auto value = parse_value(lex, scratch);
+	scratch.projection = projection;
+	if (!value.is_valid())
+	{
+		return std::move(value).forward_errors<std::optional<Value>>();
+	}
+	return ResultType(std::optional<Value>(std::move(value).value()));
+}
+
+static
+Result<List> parse_list(Lexer& lex, ParseScratch& scratch)
 {
 	if (!lex.next_is(TokenType::lbracket))
 	{
 		return Result<List>(
-			make_errors("expected '['", lex.extract_token()));
+			make_errors(ErrorCode::expected_lbracket, lex.extract_token()));
 	}
 	lex.extract_token();
 
 	if (lex.next_is(TokenType::rbracket))
 	{
-		lex.extract_token();
+		close_span(scratch, lex.extract_token());
 		return Result<List>(List{});
 	}
 
-	List values;
-
-	auto first_element = parse_value(lex);
-	if (!first_element.is_valid())
+	auto& elements = scratch.elements;
+	auto const first = elements.size();
+	auto const& limits = lex.options().limits;
+	std::size_t index = 0;
+	do
 	{
-		return first_element.forward_errors<List>();
-	}
-	values.append(std::move(first_element).value());
+		if (scratch.projection != nullptr)
+		{
+			auto const position = lex.peek_position();
+			scratch.path.emplace_back(index++);
+			auto selected = parse_selected(lex, scratch);
+			scratch.path.pop_back();
+			if (!selected.is_valid())
+			{
+				return std::move(selected).forward_errors<List>();
+			}
+			if (auto& element = selected.value(); element.has_value())
+			{
+				if (!count_allocation(scratch, limits, sizeof(Value)))
+				{
+					return Result<List>(
+						make_error(ErrorCode::too_much_memory, position));
+				}
+				elements.push_back(std::move(*element));
+			}
+			continue;
+		}
 
-	while (lex.try_extract_token(TokenType::comma))
-	{
-		auto cur_element = parse_value(lex);
+		if (!count_allocation(scratch, limits, sizeof(Value)))
+		{
+			return Result<List>(
+				make_error(ErrorCode::too_much_memory, lex.peek_position()));
+		}
+
+		if (scratch.spans != nullptr)
+		{
+			scratch.spans->next_index = elements.size() - first;
+			scratch.spans->next_key = {};
+		}
+
+		auto cur_element = parse_value(lex, scratch);
 		if (!cur_element.is_valid())
 		{
-			return cur_element.forward_errors<List>();
+			return std::move(cur_element).forward_errors<List>();
 		}
-		values.append(std::move(cur_element).value());
-	}
+		elements.push_back(std::move(cur_element).value());
+	} while (lex.try_extract_token(TokenType::comma));
 
 	if (!lex.next_is(TokenType::rbracket))
 	{
 		return Result<List>(
-			make_errors("expected ']'", lex.extract_token()));
+			make_errors(ErrorCode::expected_rbracket, lex.extract_token()));
 	}
-	lex.extract_token();
+	close_span(scratch, lex.extract_token());
 
-	return Result<List>(std::move(values));
+	return Result<List>(List(pop_items(elements, first)));
 }
 
-// Parse a string key and a value separated by a ':'.
+/*
+ * Parse a string key and a value separated by a ':'. If a projection skips
+ * the value, `skipped` is set and the value is left empty.
+ */
 static
-auto parse_object_entry(Lexer& lex)
+auto parse_object_entry(Lexer& lex, ParseScratch& scratch, bool& skipped)
 	-> Result<std::pair<std::string, Value>>
 {
 	using ResultType = Result<std::pair<std::string, Value>>;
@@ -84,119 +342,388 @@ auto parse_object_entry(Lexer& lex)
 	if (key_token.type() != TokenType::string)
 	{
 		return ResultType(
-			make_errors("expected string as key", key_token));
+			make_errors(ErrorCode::expected_key, key_token));
 	}
 
 	if (!lex.next_is(TokenType::colon))
 	{
 		return ResultType(
-			make_errors("expected ':'", lex.extract_token()));
+			make_errors(ErrorCode::expected_colon, lex.extract_token()));
 	}
 	lex.extract_token();
 
-	auto value = parse_value(lex);
+	if (scratch.projection != nullptr)
+	{
+		scratch.path.emplace_back(std::string(key_token.text()));
+		auto selected = parse_selected(lex, scratch);
+		scratch.path.pop_back();
+		if (!selected.is_valid())
+		{
+			return std::move(selected)
+				.forward_errors<std::pair<std::string, Value>>();
+		}
+		auto& value = selected.value();
+		skipped = !value.has_value();
+		return ResultType(
+			{std::move(key_token).text(), std::move(value).value_or(Value())});
+	}
+
+	if (scratch.spans != nullptr)
+	{
+		scratch.spans->next_index = 0;
+		scratch.spans->next_key = key_token.text();
+	}
+
+	auto value = parse_value(lex, scratch);
 	if (!value.is_valid())
 	{
-		return value.forward_errors<std::pair<std::string, Value>>();
+		return std::move(value)
+			.forward_errors<std::pair<std::string, Value>>();
 	}
 
-	return ResultType({std::move(key_token).text(), value.value()});
+	return ResultType(
+		{std::move(key_token).text(), std::move(value).value()});
 }
 
+/*
+ * Sort the members of the object on top of the member stack, from `first`
+ * on, and find the earliest repeated key, counting from `first`. Doing this
+ * before handing the members to `Object::assign` reuses `scratch.order`.
+ */
 static
-Result<Object> parse_object(Lexer& lex)
+std::optional<std::size_t> sort_members(
+	ParseScratch& scratch, std::size_t first)
+{
+	auto& members = scratch.members;
+	auto const count = members.size() - first;
+	auto const key = [&](std::size_t index) -> std::string const&
+	{
+		return members[first + index].first;
+	};
+
+	// Members are usually already sorted, which is checked cheaply here.
+	std::size_t i = 1;
+	while (i < count && key(i - 1) < key(i))
+	{
+		++i;
+	}
+	if (i >= count)
+	{
+		return std::nullopt;
+	}
+
+	/*
+	 * Equal keys are kept in their original order, so the repetitions are
+	 * every member after the first of a run.
+	 */
+	auto& order = scratch.order;
+	order.resize(count);
+	std::iota(std::begin(order), std::end(order), std::size_t{0});
+	std::sort(
+		std::begin(order), std::end(order),
+		[&](std::size_t a, std::size_t b)
+		{
+			auto const compared = key(a).compare(key(b));
+			return compared < 0 || (compared == 0 && a < b);
+		});
+
+	std::optional<std::size_t> repeated;
+	for (std::size_t j = 1; j < count; ++j)
+	{
+		if (key(order[j - 1]) == key(order[j]))
+		{
+			repeated = std::min(repeated.value_or(order[j]), order[j]);
+		}
+	}
+	if (repeated)
+	{
+		return repeated;
+	}
+
+	/*
+	 * Move the members into sorted order by following each cycle of the
+	 * permutation, marking each position done as it is filled.
+	 */
+	for (std::size_t j = 0; j < count; ++j)
+	{
+		if (order[j] == j)
+		{
+			continue;
+		}
+		auto held = std::move(members[first + j]);
+		auto k = j;
+		while (order[k] != j)
+		{
+			auto const next = order[k];
+			members[first + k] = std::move(members[first + next]);
+			order[k] = k;
+			k = next;
+		}
+		members[first + k] = std::move(held);
+		order[k] = k;
+	}
+	return std::nullopt;
+}
+
+/*
+ * Find where the first repeated key is in an object, among the members on
+ * the stack from `first` on, whose positions start at `first_position`, and
+ * the keys skipped from `first_skipped` on.
+ */
+static
+std::optional<SourcePosition> find_repeated_key(
+	ParseScratch const& scratch,
+	std::size_t first,
+	std::size_t first_position,
+	std::size_t first_skipped)
+{
+	std::vector<std::pair<std::string_view, SourcePosition>> keys;
+	for (auto i = first; i < scratch.members.size(); ++i)
+	{
+		keys.emplace_back(
+			scratch.members[i].first,
+			scratch.key_positions[first_position + (i - first)]);
+	}
+	for (auto i = first_skipped; i < scratch.skipped_keys.size(); ++i)
+	{
+		auto const& [key, position] = scratch.skipped_keys[i];
+		keys.emplace_back(key, position);
+	}
+	std::sort(
+		std::begin(keys), std::end(keys),
+		[](auto const& a, auto const& b)
+		{
+			return a.first < b.first
+				|| (a.first == b.first && a.second.offset < b.second.offset);
+		});
+
+	// Every key after the first of a run repeats it.
+	std::optional<SourcePosition> repeated;
+	for (std::size_t i = 1; i < keys.size(); ++i)
+	{
+		if (keys[i - 1].first == keys[i].first
+			&& (!repeated || keys[i].second.offset < repeated->offset))
+		{
+			repeated = keys[i].second;
+		}
+	}
+	return repeated;
+}
+
+static
+Result<Object> parse_object(Lexer& lex, ParseScratch& scratch)
 {
 	if (!lex.next_is(TokenType::lbrace))
 	{
 		return Result<Object>(
-			make_errors("expected '{'", lex.extract_token()));
+			make_errors(ErrorCode::expected_lbrace, lex.extract_token()));
 	}
 	lex.extract_token();
 
+	Object values(lex.options().object_storage);
 	if (lex.next_is(TokenType::rbrace))
 	{
-		lex.extract_token();
-		return Result<Object>(Object{});
+		close_span(scratch, lex.extract_token());
+		return Result<Object>(std::move(values));
 	}
 
-	Object values;
-
-	auto first_entry = parse_object_entry(lex);
-	if (!first_entry.is_valid())
+	/*
+	 * Nested objects push onto the same stacks while a member's value is
+	 * parsed, after its key position but before the member itself, so each
+	 * stack has its own start.
+	 */
+	auto& members = scratch.members;
+	auto& key_positions = scratch.key_positions;
+	auto const first = members.size();
+	auto const first_position = key_positions.size();
+	auto const first_skipped = scratch.skipped_keys.size();
+	auto const& limits = lex.options().limits;
+
+	// Leave the stacks as they were for an enclosing object, after an error.
+	auto const unwind = [&]()
 	{
-		return first_entry.forward_errors<Object>();
-	}
-
-	auto [first_key, first_value] = std::move(first_entry).value();
-	values.set_property(std::move(first_key), std::move(first_value));
+		members.resize(first);
+		key_positions.resize(first_position);
+		scratch.skipped_keys.resize(first_skipped);
+	};
+
+	/*
+	 * Repeated keys are otherwise found once the object is closed, so one
+	 * that comes before an error is looked for here, to report it first.
+	 */
+	auto const fail = [&](ErrorList errors)
+	{
+		auto const repeated =
+			find_repeated_key(scratch, first, first_position, first_skipped);
+		unwind();
+		if (repeated && repeated->offset < errors.front().position.offset)
+		{
+			return Result<Object>(
+				make_error(ErrorCode::duplicate_key, *repeated));
+		}
+		return Result<Object>(std::move(errors));
+	};
 
-	while (lex.try_extract_token(TokenType::comma))
+	do
 	{
-		auto cur_entry_first_token = lex.peek_token();
+		key_positions.push_back(lex.peek_position());
 
-		auto cur_entry = parse_object_entry(lex);
+		auto const count = members.size() - first
+			+ scratch.skipped_keys.size() - first_skipped;
+		if (count >= limits.max_members)
+		{
+			return fail(make_error(
+				ErrorCode::too_many_members, key_positions.back()));
+		}
+
+		bool skipped = false;
+		auto cur_entry = parse_object_entry(lex, scratch, skipped);
 		if (!cur_entry.is_valid())
 		{
-			return cur_entry.forward_errors<Object>();
+			return fail(std::move(cur_entry).errors());
+		}
+		if (skipped)
+		{
+			scratch.skipped_keys.emplace_back(
+				std::move(cur_entry).value().first, key_positions.back());
+			key_positions.pop_back();
+			continue;
 		}
 
-		auto [cur_key, cur_value] = std::move(cur_entry).value();
-		// It is an error if a key is repeated.
-		if (!values.try_insert(std::move(cur_key), std::move(cur_value)))
+		// Each member also has a hash, and a long key has a buffer.
+		auto const key_size = cur_entry.value().first.size();
+		auto const member_size =
+			sizeof(std::pair<std::string, Value>) + sizeof(std::uint64_t)
+				+ (key_size > Value::max_inline_string ? key_size + 1 : 0);
+		if (!count_allocation(scratch, limits, member_size))
 		{
-			return Result<Object>(
-				make_errors(
-					"key already defined",
-					cur_entry_first_token));
+			return fail(make_error(
+				ErrorCode::too_much_memory, key_positions.back()));
 		}
-	}
+		members.push_back(std::move(cur_entry).value());
+	} while (lex.try_extract_token(TokenType::comma));
 
 	if (!lex.next_is(TokenType::rbrace))
 	{
+		return fail(
+			make_errors(ErrorCode::expected_rbrace, lex.extract_token()));
+	}
+	close_span(scratch, lex.extract_token());
+
+	// It is an error if a key is repeated, even by a skipped member.
+	if (scratch.skipped_keys.size() > first_skipped)
+	{
+		auto const repeated =
+			find_repeated_key(scratch, first, first_position, first_skipped);
+		if (repeated)
+		{
+			unwind();
+			return Result<Object>(
+				make_error(ErrorCode::duplicate_key, *repeated));
+		}
+		scratch.skipped_keys.resize(first_skipped);
+	}
+	if (auto const repeated = sort_members(scratch, first))
+	{
+		auto const position = key_positions[first_position + *repeated];
+		unwind();
 		return Result<Object>(
-			make_errors("expected '}'", lex.extract_token()));
+			make_error(ErrorCode::duplicate_key, position));
 	}
-	lex.extract_token();
+	key_positions.resize(first_position);
+
+	// The members are sorted and distinct, so nothing can be repeated.
+	[[maybe_unused]] auto const assigned =
+		values.assign(pop_items(members, first));
+	assert(!assigned.has_value());
 
 	return Result<Object>(std::move(values));
 }
 
-// Parse a string, object, or list.
-static
-Result<Value> parse_value(Lexer& lex)
+[[nodiscard]]
+Result<Value> parse_value(Lexer& lex, ParseScratch& scratch)
 {
+	auto const& limits = lex.options().limits;
 	if (lex.next_is(TokenType::string))
 	{
-		return Result<Value>(lex.extract_token().text());
+		auto token = lex.extract_token();
+		if (++scratch.nodes > limits.max_nodes)
+		{
+			return Result<Value>(
+				make_error(ErrorCode::too_many_nodes, token.position()));
+		}
+		auto const size = token.text().size();
+		if (size > Value::max_inline_string
+			&& !count_allocation(
+				scratch, limits,
+				sizeof(detail::SharedNode<std::string>) + size + 1))
+		{
+			return Result<Value>(
+				make_error(ErrorCode::too_much_memory, token.position()));
+		}
+
+		if (scratch.strings != nullptr)
+		{
+			return Result<Value>(
+				scratch.strings->intern(std::move(token).text()));
+		}
+		return Result<Value>(std::move(token).text());
+	}
+	if (scratch.cancellation != nullptr
+		&& scratch.cancellation->is_cancelled())
+	{
+		return Result<Value>(
+			make_error(ErrorCode::cancelled, lex.peek_position()));
+	}
+
+	auto const is_object = lex.next_is(TokenType::lbrace);
+	if (!is_object && !lex.next_is(TokenType::lbracket))
+	{
+		return Result<Value>(
+			make_errors(ErrorCode::expected_value, lex.extract_token()));
+	}
+	if (auto const exceeded = enter_container(scratch, limits, is_object))
+	{
+		return Result<Value>(make_error(*exceeded, lex.peek_position()));
 	}
-	if (lex.next_is(TokenType::lbrace))
+	if (scratch.spans != nullptr)
 	{
-		auto object = parse_object(lex);
+		scratch.spans->open_container(lex.peek_position().offset);
+	}
+
+	if (is_object)
+	{
+		auto object = parse_object(lex, scratch);
+		--scratch.depth;
 		if (!object.is_valid())
 		{
-			return object.forward_errors<Value>();
+			return std::move(object).forward_errors<Value>();
 		}
 		return Result<Value>(std::move(object).value());
 	}
-	if (lex.next_is(TokenType::lbracket))
+
+	auto list = parse_list(lex, scratch);
+	--scratch.depth;
+	if (!list.is_valid())
 	{
-		auto list = parse_list(lex);
-		if (!list.is_valid())
-		{
-			return list.forward_errors<Value>();
-		}
-		return Result<Value>(std::move(list).value());
+		return std::move(list).forward_errors<Value>();
 	}
-	return Result<Value>(
-		make_errors("expected string, '{', or '['", lex.extract_token()));
+	return Result<Value>(std::move(list).value());
 }
 
 [[nodiscard]]
-Result<Value> parse(std::string_view str)
+[[nodiscard]]
+Result<Value> parse_document(Lexer& lex, ParseScratch& scratch)
 {
-	Lexer lex(str);
+	auto const max_input_bytes = lex.options().limits.max_input_bytes;
+	if (lex.chars().size() > max_input_bytes)
+	{
+		return Result<Value>(make_error(
+			ErrorCode::input_too_large,
+			SourcePosition{lex.chars(), max_input_bytes}));
+	}
 
-	auto value = parse_value(lex);
+	auto value = parse_value(lex, scratch);
 	if (!value.is_valid())
 	{
 		return std::move(value).forward_errors<Value>();
@@ -206,10 +733,106 @@ Result<Value> parse(std::string_view str)
 	if (next_token.type() != TokenType::eof)
 	{
 		return Result<Value>(
-			make_errors(
-				"garbage at end of input", std::move(next_token)));
+			make_errors(ErrorCode::trailing_characters, next_token));
 	}
 
 	return value;
 }
+
+Parser::Parser(ParseOptions const& options) :
+	options_(options), scratch_(std::make_unique<ParseScratch>())
+{}
+
+Parser::Parser(Parser&&) noexcept = default;
+Parser& Parser::operator=(Parser&&) noexcept = default;
+
+Parser::~Parser(void) = default;
+
+/*
+ * Get cleared buffers for a parse, creating them if they were freed or the
+ * parser was moved from.
+ */
+[[nodiscard]]
+static
+ParseScratch& start_parse(
+	std::unique_ptr<ParseScratch>& scratch,
+	CancellationToken const* cancellation)
+{
+	if (scratch == nullptr)
+	{
+		scratch = std::make_unique<ParseScratch>();
+	}
+	scratch->clear();
+	scratch->cancellation = cancellation;
+	return *scratch;
+}
+
+[[nodiscard]]
+Result<Value> Parser::parse(std::string_view str)
+{
+	Lexer lex(str, options_);
+	return parse_document(lex, start_parse(scratch_, nullptr));
+}
+
+[[nodiscard]]
+Result<Value> Parser::parse(PaddedString const& str)
+{
+	Lexer lex(str, options_);
+	return parse_document(lex, start_parse(scratch_, nullptr));
+}
+
+[[nodiscard]]
+Result<Value> Parser::parse(
+	std::string_view str, CancellationToken const& cancellation)
+{
+	Lexer lex(str, options_);
+	return parse_document(lex, start_parse(scratch_, &cancellation));
+}
+
+[[nodiscard]]
+Result<Value> Parser::parse(
+	PaddedString const& str, CancellationToken const& cancellation)
+{
+	Lexer lex(str, options_);
+	return parse_document(lex, start_parse(scratch_, &cancellation));
+}
+
+void Parser::release_memory(void)
+{
+	scratch_.reset();
+}
+
+[[nodiscard]]
+Result<Value> parse(std::string_view str, ParseOptions const& options)
+{
+	return Parser(options).parse(str);
+}
+
+[[nodiscard]]
+Result<Value> parse(PaddedString const& str, ParseOptions const& options)
+{
+	return Parser(options).parse(str);
+}
+
+[[nodiscard]]
+Result<Value> parse(
+	std::string_view str,
+	Projection const& projection,
+	ParseOptions const& options)
+{
+	Lexer lex(str, options);
+	ParseScratch scratch;
+	scratch.projection = &projection;
+	return parse_document(lex, scratch);
+}
+
+[[nodiscard]]
+Result<Value> parse(
+	std::string_view str, StringPool& pool, ParseOptions const& options)
+{
+	Lexer lex(str, options);
+	ParseScratch scratch;
+	scratch.strings = &pool;
+	return parse_document(lex, scratch);
+}
 } // namespace jsonish
@@ -0,0 +1,81 @@
+#include "jsonish/parse_async.hpp"
+
+#include <memory>
+#include <thread>
+
+namespace jsonish
+{
+void run_on_new_thread(std::function<void()> task)
+{
+	std::thread(std::move(task)).detach();
+}
+
+namespace detail
+{
+[[nodiscard]]
+Result<Value> parse_owned(
+	std::string const& document,
+	ParseOptions const& options,
+	CancellationToken const& cancellation)
+{
+	auto result = Parser(options).parse(document, cancellation);
+	if (result.is_valid())
+	{
+		return result;
+	}
+
+	// The document is freed once the task is done, so errors keep offsets.
+	auto errors = std::move(result).errors();
+	for (auto& error : errors)
+	{
+		error.position.chars = {};
+	}
+	return Result<Value>(std::move(errors));
+}
+} // namespace detail
+
+[[nodiscard]]
+std::future<Result<Value>> parse_async(
+	std::string document,
+	Executor const& executor,
+	ParseOptions const& options,
+	CancellationToken const& cancellation)
+{
+	// Executors may copy their tasks, so the state of the task is shared.
+	struct Task
+	{
+		std::string document;
+		ParseOptions options;
+		CancellationToken cancellation;
+		std::promise<Result<Value>> promise;
+	};
+	auto task = std::make_shared<Task>(
+		Task{std::move(document), options, cancellation, {}});
+	auto future = task->promise.get_future();
+
+	executor([task]()
+	{
+		try
+		{
+			task->promise.set_value(
+				detail::parse_owned(
+					task->document, task->options, task->cancellation));
+		}
+		catch (...)
+		{
+			task->promise.set_exception(std::current_exception());
+		}
+	});
+	return future;
+}
+
+[[nodiscard]]
+std::future<Result<Value>> parse_async(
+	std::string document,
+	ParseOptions const& options,
+	CancellationToken const& cancellation)
+{
+	return parse_async(
+		std::move(document), run_on_new_thread, options, cancellation);
+}
+} // namespace jsonish
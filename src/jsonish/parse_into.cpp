@@ -0,0 +1,176 @@
+#include "jsonish/parse_into.hpp"
+
+#include "jsonish/lex.hpp"
+#include "jsonish/parse_value.hpp"
+
+#include <cassert>
+
+namespace jsonish
+{
+TokenReader::TokenReader(std::string_view chars, ParseOptions const& options) :
+	lex_(std::make_unique<Lexer>(chars, options)),
+	scratch_(std::make_unique<ParseScratch>())
+{}
+
+TokenReader::TokenReader(TokenReader&&) noexcept = default;
+TokenReader& TokenReader::operator=(TokenReader&&) noexcept = default;
+
+TokenReader::~TokenReader(void) = default;
+
+bool TokenReader::read_string(std::string& out)
+{
+	auto token = lex_->extract_token();
+	if (token.type() != TokenType::string)
+	{
+		errors_ = make_errors(ErrorCode::expected_string, token);
+		return false;
+	}
+	out = std::move(token).text();
+	return true;
+}
+
+bool TokenReader::read_value(Value& out)
+{
+	scratch_->depth = at_first_item_.size();
+	auto value = parse_value(*lex_, *scratch_);
+	if (!value.is_valid())
+	{
+		errors_ = std::move(value).errors();
+		return false;
+	}
+	out = std::move(value).value();
+	return true;
+}
+
+bool TokenReader::skip_value(void)
+{
+	scratch_->depth = at_first_item_.size();
+	errors_ = jsonish::skip_value(*lex_, *scratch_);
+	return errors_.empty();
+}
+
+/*
+ * Read the token opening a container, which is one level deeper than those
+ * already open.
+ */
+static
+bool open_container(
+	Lexer& lex,
+	std::vector<bool>& at_first_item,
+	TokenType open,
+	ErrorCode expected_open,
+	ErrorList& errors)
+{
+	if (!lex.next_is(open))
+	{
+		errors = make_errors(expected_open, lex.extract_token());
+		return false;
+	}
+	if (at_first_item.size() >= lex.options().limits.max_depth)
+	{
+		errors = make_error(ErrorCode::too_deep, lex.peek_position());
+		return false;
+	}
+	lex.extract_token();
+	at_first_item.push_back(true);
+	return true;
+}
+
+bool TokenReader::begin_object(void)
+{
+	return open_container(
+		*lex_, at_first_item_,
+		TokenType::lbrace, ErrorCode::expected_lbrace, errors_);
+}
+
+/*
+ * Read the ',' separating items in the innermost container or the token
+ * closing it. Only the first item of a container is not preceded by a ','.
+ */
+static
+ReadStatus next_item(
+	Lexer& lex,
+	std::vector<bool>& at_first_item,
+	TokenType close,
+	ErrorCode expected_close,
+	ErrorList& errors)
+{
+	assert(!at_first_item.empty());
+
+	bool const first = at_first_item.back();
+	at_first_item.back() = false;
+
+	if (lex.try_extract_token(close))
+	{
+		at_first_item.pop_back();
+		return ReadStatus::end;
+	}
+	if (first || lex.try_extract_token(TokenType::comma))
+	{
+		return ReadStatus::item;
+	}
+
+	errors = make_errors(expected_close, lex.extract_token());
+	return ReadStatus::error;
+}
+
+ReadStatus TokenReader::next_member(std::string& key)
+{
+	last_position_ = lex_->peek_position();
+	auto const status = next_item(
+		*lex_, at_first_item_,
+		TokenType::rbrace, ErrorCode::expected_rbrace, errors_);
+	if (status != ReadStatus::item)
+	{
+		return status;
+	}
+
+	auto key_token = lex_->extract_token();
+	last_position_ = key_token.position();
+	if (key_token.type() != TokenType::string)
+	{
+		errors_ = make_errors(ErrorCode::expected_key, key_token);
+		return ReadStatus::error;
+	}
+	key = std::move(key_token).text();
+
+	auto colon_token = lex_->extract_token();
+	if (colon_token.type() != TokenType::colon)
+	{
+		errors_ = make_errors(ErrorCode::expected_colon, colon_token);
+		return ReadStatus::error;
+	}
+	return ReadStatus::item;
+}
+
+bool TokenReader::begin_list(void)
+{
+	return open_container(
+		*lex_, at_first_item_,
+		TokenType::lbracket, ErrorCode::expected_lbracket, errors_);
+}
+
+ReadStatus TokenReader::next_element(void)
+{
+	return next_item(
+		*lex_, at_first_item_,
+		TokenType::rbracket, ErrorCode::expected_rbracket, errors_);
+}
+
+bool TokenReader::finish(void)
+{
+	auto token = lex_->extract_token();
+	if (token.type() != TokenType::eof)
+	{
+		errors_ = make_errors(ErrorCode::trailing_characters, token);
+		return false;
+	}
+	return true;
+}
+
+void TokenReader::fail(ErrorCode code)
+{
+	errors_.push_back(
+		Error{code, last_position_.value_or(lex_->peek_position())});
+}
+} // namespace jsonish
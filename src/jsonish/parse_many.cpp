@@ -0,0 +1,103 @@
+#include "jsonish/parse_many.hpp"
+
+#include "jsonish/parse.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+namespace jsonish
+{
+[[nodiscard]]
+std::vector<Result<Value>> parse_many(
+	std::string_view const* documents,
+	std::size_t count,
+	ParseOptions const& options,
+	std::size_t thread_count)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(
+			std::size_t{std::thread::hardware_concurrency()}, std::size_t{1});
+	}
+	thread_count = std::max(std::min(thread_count, count), std::size_t{1});
+
+	// The largest documents are taken first.
+	std::vector<std::size_t> order(count);
+	std::iota(std::begin(order), std::end(order), std::size_t{0});
+	std::stable_sort(
+		std::begin(order), std::end(order),
+		[&](std::size_t a, std::size_t b)
+		{
+			return documents[a].size() > documents[b].size();
+		});
+
+	std::vector<std::optional<Result<Value>>> results(count);
+	std::atomic<std::size_t> next{0};
+
+	std::mutex error_mutex;
+	std::exception_ptr error;
+
+	auto const work = [&]()
+	{
+		try
+		{
+			Parser parser(options);
+			auto i = next.fetch_add(1, std::memory_order_relaxed);
+			for (; i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+			{
+				auto const index = order[i];
+				results[index].emplace(parser.parse(documents[index]));
+			}
+		}
+		catch (...)
+		{
+			// Stop the other threads from taking more documents.
+			next.store(count, std::memory_order_relaxed);
+
+			std::lock_guard<std::mutex> const lock(error_mutex);
+			if (!error)
+			{
+				error = std::current_exception();
+			}
+		}
+	};
+
+	// The calling thread does its share of the work too.
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count - 1);
+	try
+	{
+		for (std::size_t i = 1; i < thread_count; ++i)
+		{
+			threads.emplace_back(work);
+		}
+	}
+	catch (...)
+	{
+		// Carry on with the threads that did start.
+	}
+	work();
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	std::vector<Result<Value>> parsed;
+	parsed.reserve(count);
+	for (auto& result : results)
+	{
+		parsed.push_back(*std::move(result));
+	}
+	return parsed;
+}
+} // namespace jsonish
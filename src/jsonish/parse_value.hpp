@@ -0,0 +1,140 @@
+#ifndef JSH_PARSE_VALUE_HPP_INCLUDED
+#define JSH_PARSE_VALUE_HPP_INCLUDED
+
+#include "jsonish/cancellation.hpp"
+#include "jsonish/document.hpp"
+#include "jsonish/lex.hpp"
+#include "jsonish/path.hpp"
+#include "jsonish/projection.hpp"
+#include "jsonish/result.hpp"
+#include "jsonish/source_position.hpp"
+#include "jsonish/string_pool.hpp"
+#include "jsonish/tree.hpp"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace jsonish
+{
+/// Records where lists and objects are while parsing, for `Document`.
+struct SpanRecorder
+{
+	// The offset in the document of the lexer's first character.
+	std::size_t base = 0;
+
+	// Where the next value goes in its container.
+	std::size_t next_index = 0;
+	std::string_view next_key;
+
+	// The containers being parsed, innermost last.
+	std::vector<detail::Span> open;
+
+	// The outermost container, once it is closed.
+	detail::Span root;
+
+	void open_container(std::size_t offset)
+	{
+		detail::Span span;
+		span.offset = base + offset;
+		span.index = next_index;
+		span.key = next_key;
+		open.push_back(std::move(span));
+	}
+
+	// Close the innermost container, whose last character is at `offset`.
+	void close_container(std::size_t offset)
+	{
+		auto span = std::move(open.back());
+		open.pop_back();
+		span.length = base + offset + 1 - span.offset;
+		if (open.empty())
+		{
+			root = std::move(span);
+			return;
+		}
+		open.back().children.push_back(std::move(span));
+	}
+};
+
+/** Buffers used while parsing, which a `Parser` keeps between parses.
+ *
+ * The items of every open container are kept on shared stacks, innermost
+ * last, so that a container is built with a single allocation of its final
+ * size once it is closed.
+ */
+struct ParseScratch
+{
+	// Elements of the lists being parsed.
+	std::vector<Value> elements;
+
+	// Members of the objects being parsed, and where each key starts.
+	std::vector<std::pair<std::string, Value>> members;
+	std::vector<SourcePosition> key_positions;
+
+	// Used to sort the members of an object.
+	std::vector<std::size_t> order;
+
+	// Checked as each container starts, if set.
+	CancellationToken const* cancellation = nullptr;
+
+	// Told about each container, if set.
+	SpanRecorder* spans = nullptr;
+
+	// Shares the storage of string values, if set.
+	StringPool* strings = nullptr;
+
+	// Asked about each item, if set, with the path to it in `path`.
+	Projection const* projection = nullptr;
+	Path path;
+
+	// Keys of members the projection skipped, and where each starts.
+	std::vector<std::pair<std::string, SourcePosition>> skipped_keys;
+
+	// For each container being skipped, whether it is an object.
+	std::vector<bool> skipping;
+
+	// What the tree built so far uses, counted against `ParseLimits`.
+	std::size_t depth = 0;
+	std::size_t nodes = 0;
+	std::size_t allocated_bytes = 0;
+
+	void clear(void) noexcept
+	{
+		elements.clear();
+		members.clear();
+		key_positions.clear();
+		order.clear();
+		path.clear();
+		skipped_keys.clear();
+		skipping.clear();
+		depth = 0;
+		nodes = 0;
+		allocated_bytes = 0;
+	}
+};
+
+/// Make an error list with the given error along with any lexer errors.
+[[nodiscard]]
+ErrorList make_errors(ErrorCode code, Token const& error_token);
+
+/// Make an error list holding a single error.
+[[nodiscard]]
+ErrorList make_error(ErrorCode code, SourcePosition position);
+
+/// Check the value at the start of `lex` without building it.
+[[nodiscard]]
+ErrorList skip_value(Lexer& lex, ParseScratch& scratch);
+
+/// Parse a string, object, or list from the tokens in `lex`.
+[[nodiscard]]
+Result<Value> parse_value(Lexer& lex, ParseScratch& scratch);
+
+/// Parse a whole value and check that nothing but whitespace follows it.
+[[nodiscard]]
+Result<Value> parse_document(Lexer& lex, ParseScratch& scratch);
+} // namespace jsonish
+
+#endif
@@ -0,0 +1,37 @@
+#include "jsonish/projection.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace jsonish
+{
+// Indicate whether `prefix` is the start of `path`, or all of it.
+[[nodiscard]]
+static
+bool starts_with(Path const& path, Path const& prefix)
+{
+	return prefix.size() <= path.size()
+		&& std::equal(std::begin(prefix), std::end(prefix), std::begin(path));
+}
+
+Projection::Projection(std::vector<Path> paths) :
+	select_(
+		[paths = std::move(paths)](Path const& path)
+		{
+			auto selection = Selection::skip;
+			for (auto const& selected : paths)
+			{
+				if (starts_with(path, selected))
+				{
+					return Selection::keep;
+				}
+				if (starts_with(selected, path))
+				{
+					selection = Selection::descend;
+				}
+			}
+			return selection;
+		})
+{}
+} // namespace jsonish
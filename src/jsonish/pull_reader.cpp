@@ -0,0 +1,276 @@
+#include "jsonish/pull_reader.hpp"
+
+#include "jsonish/detail/chars.hpp"
+#include "jsonish/lex.hpp"
+#include "jsonish/parse_value.hpp"
+#include "jsonish/unescape.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace jsonish
+{
+std::size_t FdSource::read(char* buffer, std::size_t size)
+{
+	while (true)
+	{
+#ifdef _WIN32
+		auto const count = ::_read(
+			fd_, buffer,
+			static_cast<unsigned int>(std::min<std::size_t>(size, 1u << 30)));
+#else
+		auto const count = ::read(fd_, buffer, size);
+#endif
+		if (count >= 0)
+		{
+			return static_cast<std::size_t>(count);
+		}
+		if (errno != EINTR)
+		{
+			throw std::system_error(
+				errno, std::generic_category(), "jsonish::FdSource");
+		}
+	}
+}
+
+std::size_t StreamSource::read(char* buffer, std::size_t size)
+{
+	stream_->read(buffer, static_cast<std::streamsize>(size));
+	if (stream_->bad())
+	{
+		throw std::ios_base::failure("jsonish::StreamSource");
+	}
+	return static_cast<std::size_t>(stream_->gcount());
+}
+
+PullReader::PullReader(
+	Source& source,
+	ParseOptions const& options,
+	std::size_t buffer_size) :
+	source_(&source),
+	options_(options),
+	buffer_(std::make_unique<char[]>(buffer_size == 0 ? 1 : buffer_size)),
+	capacity_(buffer_size == 0 ? 1 : buffer_size)
+{}
+
+bool PullReader::fill(void)
+{
+	if (exhausted_)
+	{
+		return false;
+	}
+
+	if (end_ == capacity_ && pos_ > 0)
+	{
+		std::memmove(buffer_.get(), buffer_.get() + pos_, end_ - pos_);
+		base_ += pos_;
+		end_ -= pos_;
+		pos_ = 0;
+	}
+	if (end_ == capacity_)
+	{
+		return false;
+	}
+
+	auto const count = source_->read(buffer_.get() + end_, capacity_ - end_);
+	if (count == 0)
+	{
+		exhausted_ = true;
+		return false;
+	}
+	end_ += count;
+
+	auto const max_input_bytes = options_.limits.max_input_bytes;
+	if (base_ + end_ > max_input_bytes)
+	{
+		return fail(ErrorCode::input_too_large, max_input_bytes);
+	}
+	return true;
+}
+
+bool PullReader::next(void)
+{
+	if (error_)
+	{
+		return false;
+	}
+	text_ = {};
+
+	// Nothing before `pos_` is needed any more.
+	while (true)
+	{
+		while (pos_ < end_ && detail::is_space(buffer_[pos_]))
+		{
+			++pos_;
+		}
+		if (pos_ < end_)
+		{
+			break;
+		}
+		base_ += pos_;
+		pos_ = end_ = 0;
+		if (!fill())
+		{
+			if (!error_)
+			{
+				offset_ = base_;
+			}
+			return false;
+		}
+	}
+
+	offset_ = base_ + pos_;
+	switch (buffer_[pos_++])
+	{
+	case '{': kind_ = TokenKind::lbrace; return true;
+	case '}': kind_ = TokenKind::rbrace; return true;
+	case '[': kind_ = TokenKind::lbracket; return true;
+	case ']': kind_ = TokenKind::rbracket; return true;
+	case ',': kind_ = TokenKind::comma; return true;
+	case ':': kind_ = TokenKind::colon; return true;
+	case '"': kind_ = TokenKind::string; return read_string();
+	default: return fail(ErrorCode::unexpected_character, offset_);
+	}
+}
+
+bool PullReader::read_string(void)
+{
+	/*
+	 * Find where the string ends: at an unescaped '"', or at a control
+	 * character, which is an error reported once the string is decoded.
+	 * A string that fills the buffer is moved to `gathered_`.
+	 */
+	gathered_.clear();
+	bool gathering = false;
+	bool escaped = false;
+	auto scan = pos_;
+	auto const max_length = options_.limits.max_string_length;
+	auto const max_chars = max_escaped_length(max_length);
+	while (true)
+	{
+		for (; scan < end_; ++scan)
+		{
+			auto const c = buffer_[scan];
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				break;
+			}
+			if (escaped)
+			{
+				escaped = false;
+			}
+			else if (c == '\\')
+			{
+				escaped = true;
+			}
+			else if (c == '"')
+			{
+				break;
+			}
+		}
+		if (scan < end_)
+		{
+			++scan;
+			break;
+		}
+
+		// Stop gathering a string once it is certain to be too long.
+		if (gathered_.size() + (scan - pos_) > max_chars)
+		{
+			return fail(ErrorCode::string_too_long, offset_);
+		}
+
+		if (end_ == capacity_)
+		{
+			gathered_.append(buffer_.get() + pos_, end_ - pos_);
+			gathering = true;
+			base_ += end_;
+			pos_ = end_ = scan = 0;
+		}
+		auto const kept = pos_;
+		if (!fill())
+		{
+			if (error_)
+			{
+				return false;
+			}
+			break;
+		}
+		scan -= kept - pos_;
+	}
+
+	std::string_view chars(buffer_.get() + pos_, scan - pos_);
+	pos_ = scan;
+	if (gathering)
+	{
+		gathered_.append(chars);
+		chars = gathered_;
+	}
+
+	bool has_escapes = false;
+	auto const result =
+		scan_string(chars, options_.validate_utf8, has_escapes);
+	if (result.error.has_value())
+	{
+		return fail(*result.error, offset_);
+	}
+
+	// Text without escapes is used where it is.
+	if (!has_escapes)
+	{
+		if (chars.size() - 1 > max_length)
+		{
+			return fail(ErrorCode::string_too_long, offset_);
+		}
+		text_ = chars.substr(0, chars.size() - 1);
+		return true;
+	}
+
+	decoded_.clear();
+	auto const decoded = unescape_string(
+		chars, decoded_, options_.validate_utf8, max_length);
+	if (decoded.error.has_value())
+	{
+		return fail(*decoded.error, offset_);
+	}
+	text_ = decoded_;
+	return true;
+}
+
+bool PullReader::fail(ErrorCode code, std::size_t offset)
+{
+	offset_ = offset;
+	text_ = {};
+	error_ = Error{code, SourcePosition{{}, offset}};
+	return false;
+}
+
+[[nodiscard]]
+Result<Value> parse(
+	Source& source,
+	ParseOptions const& options,
+	std::size_t buffer_size)
+{
+	PullReader reader(source, options, buffer_size);
+	Lexer lex(reader);
+	ParseScratch scratch;
+	auto result = parse_document(lex, scratch);
+
+	// Input that is too long is reported alone, as by the other parsers.
+	auto const& error = reader.error();
+	if (error && error->code == ErrorCode::input_too_large)
+	{
+		return Result<Value>(ErrorList{*error});
+	}
+	return result;
+}
+} // namespace jsonish
@@ -0,0 +1,36 @@
+#include "jsonish/result.hpp"
+
+#include <algorithm>
+
+namespace jsonish
+{
+[[nodiscard]]
+std::string Error::message(void) const
+{
+	// Without the characters, as for streamed input, only the offset is known.
+	if (position.chars.empty())
+	{
+		std::string result(reason());
+		result += " at offset ";
+		result += std::to_string(position.offset);
+		return result;
+	}
+
+	auto const before = position.chars.substr(
+		0, std::min(position.offset, position.chars.size()));
+
+	auto const line = static_cast<std::size_t>(
+		std::count(std::cbegin(before), std::cend(before), '\n')) + 1;
+	auto const line_start = before.rfind('\n');
+	auto const column = line_start == std::string_view::npos
+		? before.size() + 1
+		: before.size() - line_start;
+
+	std::string result(reason());
+	result += " at line ";
+	result += std::to_string(line);
+	result += ", column ";
+	result += std::to_string(column);
+	return result;
+}
+} // namespace jsonish
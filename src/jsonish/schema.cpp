@@ -0,0 +1,339 @@
+#include "jsonish/schema.hpp"
+
+#include "jsonish/detail/hash.hpp"
+#include "jsonish/lex.hpp"
+#include "jsonish/parse_value.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace jsonish
+{
+// Get the smallest power of two that is at least `n`.
+[[nodiscard]] static
+std::size_t next_power_of_two(std::size_t n) noexcept
+{
+	std::size_t result = 1;
+	while (result < n)
+	{
+		result *= 2;
+	}
+	return result;
+}
+
+// Get the slot, among `slot_count`, of a hash with a given displacement.
+[[nodiscard]] static
+std::size_t displaced_slot(
+	std::uint64_t hash,
+	std::uint32_t displacement,
+	std::size_t slot_count) noexcept
+{
+	auto const mixed =
+		detail::mix_hash(hash ^ (displacement * 0x9e3779b97f4a7c15u));
+	return static_cast<std::size_t>(mixed) & (slot_count - 1);
+}
+
+// Get the bucket, among `bucket_count`, of a hash.
+[[nodiscard]] static
+std::size_t bucket_of(std::uint64_t hash, std::size_t bucket_count) noexcept
+{
+	return static_cast<std::size_t>(hash >> 32) & (bucket_count - 1);
+}
+
+Schema::Schema(std::vector<Field> fields) :
+	fields_(std::move(fields))
+{
+	for (std::size_t i = 0; i < fields_.size(); ++i)
+	{
+		for (std::size_t j = 0; j < i; ++j)
+		{
+			if (fields_[i].key == fields_[j].key)
+			{
+				throw std::invalid_argument(
+					"schema has a repeated key");
+			}
+		}
+	}
+
+	/*
+	 * A load factor of at most one half makes displacements easy to find.
+	 * More slots cannot separate keys whose hashes are equal, so only a few
+	 * doublings are tried.
+	 */
+	constexpr int max_doublings = 8;
+	auto slot_count = next_power_of_two(2 * fields_.size());
+	for (int doublings = 0; !try_build(slot_count); ++doublings)
+	{
+		if (doublings == max_doublings)
+		{
+			throw std::invalid_argument(
+				"schema keys could not be given distinct slots");
+		}
+		slot_count *= 2;
+	}
+}
+
+bool Schema::try_build(std::size_t slot_count)
+{
+	// Limit on the displacements tried for a bucket before giving up.
+	constexpr std::uint32_t max_displacement = 1 << 16;
+
+	auto const bucket_count =
+		next_power_of_two(std::max<std::size_t>(fields_.size() / 2, 1));
+	displacements_.assign(bucket_count, 0);
+	slots_.assign(slot_count, 0);
+
+	std::vector<std::uint64_t> hashes;
+	std::vector<std::vector<std::size_t>> buckets(bucket_count);
+	for (std::size_t i = 0; i < fields_.size(); ++i)
+	{
+		hashes.push_back(detail::hash_key(fields_[i].key));
+		buckets[bucket_of(hashes.back(), bucket_count)].push_back(i);
+	}
+
+	// Place the largest buckets first, while most slots are free.
+	std::vector<std::size_t> order(bucket_count);
+	std::iota(std::begin(order), std::end(order), std::size_t{0});
+	std::stable_sort(
+		std::begin(order), std::end(order),
+		[&buckets](std::size_t a, std::size_t b) {
+			return buckets[a].size() > buckets[b].size();
+		});
+
+	std::vector<std::size_t> chosen;
+	for (auto const bucket : order)
+	{
+		auto const& members = buckets[bucket];
+		if (members.empty())
+		{
+			break;
+		}
+
+		bool placed = false;
+		for (std::uint32_t d = 0; d < max_displacement && !placed; ++d)
+		{
+			chosen.clear();
+			placed = true;
+			for (auto const field : members)
+			{
+				auto const slot =
+					displaced_slot(hashes[field], d, slot_count);
+				if (slots_[slot] != 0
+					|| std::find(
+						std::cbegin(chosen), std::cend(chosen), slot)
+						!= std::cend(chosen))
+				{
+					placed = false;
+					break;
+				}
+				chosen.push_back(slot);
+			}
+
+			if (placed)
+			{
+				displacements_[bucket] = d;
+				for (std::size_t i = 0; i < members.size(); ++i)
+				{
+					slots_[chosen[i]] =
+						static_cast<std::uint32_t>(members[i] + 1);
+				}
+			}
+		}
+
+		if (!placed)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+[[nodiscard]]
+std::size_t Schema::slot_of(std::uint64_t hash) const noexcept
+{
+	auto const displacement =
+		displacements_[bucket_of(hash, displacements_.size())];
+	return displaced_slot(hash, displacement, slots_.size());
+}
+
+[[nodiscard]]
+std::optional<std::size_t> Schema::index_of(
+	std::string_view key) const noexcept
+{
+	auto const entry = slots_[slot_of(detail::hash_key(key))];
+	if (entry == 0 || fields_[entry - 1].key != key)
+	{
+		return std::nullopt;
+	}
+	return entry - 1;
+}
+
+[[nodiscard]]
+auto Record::field(std::size_t index) const noexcept -> MaybeValueReference
+{
+	if (index >= values_.size() || !values_[index].has_value())
+	{
+		return MaybeValueReference::empty();
+	}
+	return MaybeValueReference::value(*values_[index]);
+}
+
+[[nodiscard]]
+auto Record::property(std::string_view key) const noexcept
+	-> MaybeValueReference
+{
+	auto const index = schema_->index_of(key);
+	if (!index.has_value())
+	{
+		return MaybeValueReference::empty();
+	}
+	return field(*index);
+}
+
+void Record::set_field(std::size_t index, Value value)
+{
+	values_.at(index) = std::move(value);
+}
+
+// Get the token type that starts a value of the given kind.
+[[nodiscard]] static
+TokenType first_token_of(ValueKind kind) noexcept
+{
+	switch (kind)
+	{
+	case ValueKind::string: return TokenType::string;
+	case ValueKind::list: return TokenType::lbracket;
+	case ValueKind::object: return TokenType::lbrace;
+	default: return TokenType::invalid;
+	}
+}
+
+// Parse one key and its value into `record`, checking it against the schema.
+[[nodiscard]] static
+std::optional<ErrorList> parse_field(
+	Lexer& lex,
+	ParseScratch& scratch,
+	Schema const& schema,
+	Record& record,
+	std::vector<bool>& seen)
+{
+	auto key_token = lex.extract_token();
+	if (key_token.type() != TokenType::string)
+	{
+		return make_errors(ErrorCode::expected_key, key_token);
+	}
+
+	auto const index = schema.index_of(key_token.text());
+	if (!index.has_value())
+	{
+		return make_errors(ErrorCode::unknown_key, key_token);
+	}
+	if (seen[*index])
+	{
+		return make_errors(ErrorCode::duplicate_key, key_token);
+	}
+	seen[*index] = true;
+
+	if (!lex.next_is(TokenType::colon))
+	{
+		return make_errors(ErrorCode::expected_colon, lex.extract_token());
+	}
+	lex.extract_token();
+
+	// Check the kind before parsing so that violations fail fast.
+	if (!lex.next_is(first_token_of(schema.field(*index).kind)))
+	{
+		auto const value_start = lex.peek_position();
+		if (lex.next_is(TokenType::string)
+			|| lex.next_is(TokenType::lbracket)
+			|| lex.next_is(TokenType::lbrace))
+		{
+			return ErrorList{Error{ErrorCode::wrong_kind, value_start}};
+		}
+		return make_errors(ErrorCode::expected_value, lex.extract_token());
+	}
+
+	auto value = parse_value(lex, scratch);
+	if (!value.is_valid())
+	{
+		return std::move(value).errors();
+	}
+	record.set_field(*index, std::move(value).value());
+	return std::nullopt;
+}
+
+[[nodiscard]]
+Result<Record> parse(
+	std::string_view str, Schema const& schema, ParseOptions const& options)
+{
+	auto const& limits = options.limits;
+	if (str.size() > limits.max_input_bytes)
+	{
+		return Result<Record>(make_error(
+			ErrorCode::input_too_large,
+			SourcePosition{str, limits.max_input_bytes}));
+	}
+
+	Lexer lex(str, options);
+
+	auto open_token = lex.extract_token();
+	if (open_token.type() != TokenType::lbrace)
+	{
+		return Result<Record>(
+			make_errors(ErrorCode::expected_lbrace, open_token));
+	}
+
+	// The fields are counted against the limits as members of the record.
+	ParseScratch scratch;
+	scratch.depth = 1;
+	if (limits.max_depth == 0 || limits.max_nodes == 0)
+	{
+		return Result<Record>(make_error(
+			limits.max_depth == 0
+				? ErrorCode::too_deep
+				: ErrorCode::too_many_nodes,
+			open_token.position()));
+	}
+	scratch.nodes = 1;
+
+	Record record(schema);
+	std::vector<bool> seen(schema.size(), false);
+	if (!lex.next_is(TokenType::rbrace))
+	{
+		do
+		{
+			auto errors = parse_field(lex, scratch, schema, record, seen);
+			if (errors.has_value())
+			{
+				return Result<Record>(std::move(*errors));
+			}
+		} while (lex.try_extract_token(TokenType::comma));
+	}
+
+	auto close_token = lex.extract_token();
+	if (close_token.type() != TokenType::rbrace)
+	{
+		return Result<Record>(
+			make_errors(ErrorCode::expected_rbrace, close_token));
+	}
+
+	for (std::size_t i = 0; i < schema.size(); ++i)
+	{
+		if (schema.field(i).required && !seen[i])
+		{
+			auto const error = Error{
+				ErrorCode::missing_member, close_token.position()};
+			return Result<Record>(ErrorList{error});
+		}
+	}
+
+	auto end_token = lex.extract_token();
+	if (end_token.type() != TokenType::eof)
+	{
+		return Result<Record>(
+			make_errors(ErrorCode::trailing_characters, end_token));
+	}
+	return Result<Record>(std::move(record));
+}
+} // namespace jsonish
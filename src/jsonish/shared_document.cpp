@@ -0,0 +1,73 @@
+#include "jsonish/shared_document.hpp"
+
+#include <thread>
+
+namespace jsonish
+{
+// Get the shard of the calling thread, assigning shards round robin.
+[[nodiscard]]
+static
+std::size_t thread_shard(std::size_t shard_count) noexcept
+{
+	static std::atomic<std::size_t> next_shard{0};
+	thread_local std::size_t const shard =
+		next_shard.fetch_add(1, std::memory_order_relaxed);
+	return shard % shard_count;
+}
+
+SharedDocument::SharedDocument(Value value) :
+	current_(new Value(std::move(value)))
+{}
+
+SharedDocument::~SharedDocument(void)
+{
+	delete current_.load();
+}
+
+auto SharedDocument::read(void) const noexcept -> Reader
+{
+	/*
+	 * The counter is incremented before the value is loaded. A replacement
+	 * that does not see the increment has already swapped in its value, so
+	 * this reader sees that one.
+	 */
+	auto& shard = shards_[thread_shard(shard_count)];
+	auto& counter = shard.readers[epoch_.load() & 1];
+	counter.fetch_add(1);
+	return Reader(counter, *current_.load());
+}
+
+void SharedDocument::wait_for_readers(std::size_t epoch) const noexcept
+{
+	for (auto& shard : shards_)
+	{
+		while (shard.readers[epoch].load() != 0)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void SharedDocument::store(Value value)
+{
+	auto const* const replacement = new Value(std::move(value));
+
+	std::lock_guard<std::mutex> const lock(store_mutex_);
+	auto const* const old = current_.exchange(replacement);
+
+	/*
+	 * Any reader of the old value incremented a counter before the swap,
+	 * so waiting until both counters of every shard have been seen at zero
+	 * waits for all of them. Only readers that loaded the epoch before the
+	 * last flip use the inactive counters, so those drain first. Flipping
+	 * the epoch then sends new readers to the drained counters while the
+	 * others drain in turn.
+	 */
+	auto const active = epoch_.load() & 1;
+	wait_for_readers(active ^ 1);
+	epoch_.fetch_add(1);
+	wait_for_readers(active);
+
+	delete old;
+}
+} // namespace jsonish
@@ -0,0 +1,33 @@
+#include "jsonish/static_document.hpp"
+
+namespace jsonish
+{
+[[nodiscard]]
+Value StaticValue::to_value(void) const
+{
+	if (is_string())
+	{
+		return Value(std::string(as_string()));
+	}
+	if (is_list())
+	{
+		List list;
+		for (std::size_t i = 0; i < size(); ++i)
+		{
+			list.append(at(i).to_value());
+		}
+		return Value(std::move(list));
+	}
+	if (is_object())
+	{
+		Object object;
+		for (std::size_t i = 0; i < size(); ++i)
+		{
+			auto const member = at(i);
+			object.try_insert(std::string(member.key()), member.to_value());
+		}
+		return Value(std::move(object));
+	}
+	throw std::logic_error("static value does not exist");
+}
+} // namespace jsonish
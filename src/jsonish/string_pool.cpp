@@ -0,0 +1,72 @@
+#include "jsonish/string_pool.hpp"
+
+#include "jsonish/detail/hash.hpp"
+
+#include <utility>
+
+namespace jsonish
+{
+[[nodiscard]]
+Value StringPool::intern(std::string str)
+{
+	if (str.size() <= Value::max_inline_string)
+	{
+		return Value(std::move(str));
+	}
+	++stats_.strings;
+
+	auto const hash = detail::hash_key(str);
+	if (!slots_.empty())
+	{
+		auto const mask = slots_.size() - 1;
+		for (auto slot = detail::mix_hash(hash) & mask; slots_[slot] != 0;
+			slot = (slot + 1) & mask)
+		{
+			auto const index = std::size_t{slots_[slot] - 1};
+			if (hashes_[index] == hash && values_[index].as_string() == str)
+			{
+				++stats_.shared;
+				stats_.bytes_saved +=
+					sizeof(detail::SharedNode<std::string>)
+						+ str.capacity() + 1;
+				return values_[index];
+			}
+		}
+	}
+
+	values_.emplace_back(std::move(str));
+	hashes_.push_back(hash);
+	if (slots_.size() < 2 * values_.size())
+	{
+		slots_.assign(slots_.empty() ? 16 : 2 * slots_.size(), 0);
+		for (std::size_t i = 0; i < values_.size(); ++i)
+		{
+			place(i);
+		}
+	}
+	else
+	{
+		place(values_.size() - 1);
+	}
+	return values_.back();
+}
+
+void StringPool::clear(void) noexcept
+{
+	values_.clear();
+	hashes_.clear();
+	slots_.clear();
+	stats_ = Stats{};
+}
+
+void StringPool::place(std::size_t index) noexcept
+{
+	auto const mask = slots_.size() - 1;
+	auto slot = detail::mix_hash(hashes_[index]) & mask;
+	while (slots_[slot] != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	slots_[slot] = static_cast<std::uint32_t>(index + 1);
+}
+} // namespace jsonish
@@ -0,0 +1,97 @@
+#include "jsonish/tokenizer.hpp"
+
+#include "jsonish/detail/chars.hpp"
+#include "jsonish/unescape.hpp"
+
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+namespace jsonish
+{
+bool Tokenizer::tokenize(std::string_view chars)
+{
+	if (chars.size() > std::numeric_limits<std::uint32_t>::max())
+	{
+		throw std::length_error("input too long to tokenize");
+	}
+
+	source_ = chars;
+	tokens_.clear();
+	error_.reset();
+
+	auto const push = [this](TokenKind kind, std::size_t offset,
+		std::size_t length, bool has_escapes = false)
+	{
+		tokens_.push_back(CompactToken{
+			kind,
+			has_escapes,
+			static_cast<std::uint32_t>(offset),
+			static_cast<std::uint32_t>(length)});
+	};
+
+	std::size_t pos = 0;
+	while (true)
+	{
+		while (pos < chars.size() && detail::is_space(chars[pos]))
+		{
+			++pos;
+		}
+		if (pos == chars.size())
+		{
+			return true;
+		}
+
+		auto const start = pos;
+		switch (chars[pos++])
+		{
+		case '{': push(TokenKind::lbrace, start, 1); continue;
+		case '}': push(TokenKind::rbrace, start, 1); continue;
+		case '[': push(TokenKind::lbracket, start, 1); continue;
+		case ']': push(TokenKind::rbracket, start, 1); continue;
+		case ',': push(TokenKind::comma, start, 1); continue;
+		case ':': push(TokenKind::colon, start, 1); continue;
+		case '"': break;
+		default:
+			error_ = Error{
+				ErrorCode::unexpected_character,
+				SourcePosition{chars, start}};
+			return false;
+		}
+
+		bool has_escapes;
+		auto const result = scan_string(
+			chars.substr(pos), options_.validate_utf8, has_escapes);
+		if (result.error)
+		{
+			error_ = Error{*result.error, SourcePosition{chars, start}};
+			return false;
+		}
+		pos += result.consumed;
+		push(TokenKind::string, start, pos - start, has_escapes);
+	}
+}
+
+void Tokenizer::decode(CompactToken const& token, std::string& out) const
+{
+	assert(token.kind == TokenKind::string);
+	if (!token.has_escapes)
+	{
+		out += contents(token);
+		return;
+	}
+
+	// Decoding stops at the closing quote, so it is included.
+	[[maybe_unused]] auto const result = unescape_string(
+		raw(token).substr(1), out, options_.validate_utf8);
+	assert(!result.error.has_value());
+}
+
+[[nodiscard]]
+std::string Tokenizer::text(CompactToken const& token) const
+{
+	std::string out;
+	decode(token, out);
+	return out;
+}
+} // namespace jsonish
@@ -1,5 +1,9 @@
 #include "jsonish/tree.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
 namespace jsonish
 {
 [[nodiscard]]
@@ -12,35 +16,337 @@ auto List::at(std::size_t index) const noexcept -> MaybeValueReference
 	return MaybeValueReference::value(values_[index]);
 }
 
+std::optional<std::size_t> Object::assign(
+	std::vector<std::pair<std::string, Value>> members)
+{
+	values_.clear();
+	hashes_.clear();
+	slots_.clear();
+
+	auto const key_less = [&](std::size_t a, std::size_t b)
+	{
+		return members[a].first < members[b].first;
+	};
+
+	std::size_t i = 1;
+	while (i < members.size() && key_less(i - 1, i))
+	{
+		++i;
+	}
+
+	// Members are usually already sorted, which is checked cheaply above.
+	if (i < members.size())
+	{
+		std::vector<std::size_t> order(members.size());
+		std::iota(std::begin(order), std::end(order), std::size_t{0});
+		std::stable_sort(std::begin(order), std::end(order), key_less);
+
+		/*
+		 * A stable sort keeps equal keys in their original order, so the
+		 * repetitions are every member after the first of a run.
+		 */
+		std::optional<std::size_t> repeated;
+		for (std::size_t j = 1; j < order.size(); ++j)
+		{
+			if (!key_less(order[j - 1], order[j]))
+			{
+				repeated = std::min(repeated.value_or(order[j]), order[j]);
+			}
+		}
+		if (repeated)
+		{
+			return repeated;
+		}
+
+		std::vector<std::pair<std::string, Value>> sorted;
+		sorted.reserve(members.size());
+		for (auto const index : order)
+		{
+			sorted.push_back(std::move(members[index]));
+		}
+		members = std::move(sorted);
+	}
+
+	values_ = std::move(members);
+	hashes_.reserve(values_.size());
+	for (auto const& member : values_)
+	{
+		hashes_.push_back(detail::hash_key(member.first));
+	}
+	update_index();
+	return std::nullopt;
+}
+
 bool Object::try_insert(std::string key, Value const& value)
 {
-	return values_.emplace(std::move(key), value).second;
+	return try_insert(std::move(key), Value(value));
 }
 
 bool Object::try_insert(std::string key, Value&& value)
 {
-	return values_.emplace(std::move(key), std::move(value)).second;
+	auto const index = lower_bound(key);
+	if (index < values_.size() && values_[index].first == key)
+	{
+		return false;
+	}
+	insert_at(index, std::move(key), std::move(value));
+	return true;
 }
 
 void Object::set_property(std::string key, Value const& value)
 {
-	values_.insert_or_assign(std::move(key), value);
+	set_property(std::move(key), Value(value));
 }
 
 void Object::set_property(std::string key, Value&& value)
 {
-	values_.insert_or_assign(std::move(key), std::move(value));
+	auto const index = lower_bound(key);
+	if (index < values_.size() && values_[index].first == key)
+	{
+		values_[index].second = std::move(value);
+		return;
+	}
+	insert_at(index, std::move(key), std::move(value));
+}
+
+bool Object::erase(std::string_view key)
+{
+	auto const index = find(key);
+	if (!index)
+	{
+		return false;
+	}
+	auto const offset = static_cast<std::ptrdiff_t>(*index);
+	hashes_.erase(std::cbegin(hashes_) + offset);
+	values_.erase(std::cbegin(values_) + offset);
+	update_index();
+	return true;
 }
 
 [[nodiscard]]
 auto Object::property(std::string_view key) const noexcept -> MaybeValueReference
 {
-	auto const value_pos = values_.find(key);
-	if (value_pos == std::cend(values_))
+	auto const index = find(key);
+	if (!index)
 	{
 		return MaybeValueReference::empty();
 	}
-	return MaybeValueReference::value(value_pos->second);
+	return MaybeValueReference::value(values_[*index].second);
+}
+
+[[nodiscard]]
+auto Object::property(KeyHandle const& handle) const noexcept
+	-> MaybeValueReference
+{
+	auto const hint = handle.hint();
+	if (hint < values_.size()
+		&& hashes_[hint] == handle.hash()
+		&& values_[hint].first == handle.key())
+	{
+		return MaybeValueReference::value(values_[hint].second);
+	}
+
+	auto const index = find(handle.key(), handle.hash());
+	if (!index)
+	{
+		return MaybeValueReference::empty();
+	}
+	handle.set_hint(*index);
+	return MaybeValueReference::value(values_[*index].second);
+}
+
+[[nodiscard]]
+std::size_t Object::lower_bound(std::string_view key) const noexcept
+{
+	// Members are often inserted in order, so check the end first.
+	if (values_.empty() || values_.back().first < key)
+	{
+		return values_.size();
+	}
+
+	auto const pos = std::lower_bound(
+		std::cbegin(values_), std::cend(values_), key,
+		[](auto const& member, std::string_view k)
+		{
+			return member.first < k;
+		});
+	return static_cast<std::size_t>(pos - std::cbegin(values_));
+}
+
+[[nodiscard]]
+std::optional<std::size_t> Object::find(std::string_view key) const noexcept
+{
+	if (is_hashed())
+	{
+		return find(key, detail::hash_key(key));
+	}
+	return find(key, 0);
+}
+
+[[nodiscard]]
+std::optional<std::size_t> Object::find(
+	std::string_view key, std::uint64_t hash) const noexcept
+{
+	if (is_hashed())
+	{
+		auto const mask = slots_.size() - 1;
+		for (auto slot = detail::mix_hash(hash) & mask;;
+			slot = (slot + 1) & mask)
+		{
+			if (slots_[slot] == 0)
+			{
+				return std::nullopt;
+			}
+
+			auto const index = std::size_t{slots_[slot] - 1};
+			if (hashes_[index] == hash && values_[index].first == key)
+			{
+				return index;
+			}
+		}
+	}
+
+	/*
+	 * A three-way comparison ends the search as soon as the key is found,
+	 * and saves comparing the key again afterwards.
+	 */
+	std::size_t first = 0;
+	std::size_t count = values_.size();
+	while (count > 0)
+	{
+		auto const half = count / 2;
+		auto const order =
+			std::string_view(values_[first + half].first).compare(key);
+		if (order == 0)
+		{
+			return first + half;
+		}
+		if (order < 0)
+		{
+			first += half + 1;
+			count -= half + 1;
+		}
+		else
+		{
+			count = half;
+		}
+	}
+	return std::nullopt;
+}
+
+void Object::insert_at(std::size_t index, std::string key, Value value)
+{
+	auto const offset = static_cast<std::ptrdiff_t>(index);
+	hashes_.insert(std::cbegin(hashes_) + offset, detail::hash_key(key));
+	values_.emplace(
+		std::cbegin(values_) + offset, std::move(key), std::move(value));
+
+	// Appending does not move other members, so they keep their slots.
+	if (index + 1 == values_.size()
+		&& is_hashed()
+		&& slots_.size() >= 2 * values_.size())
+	{
+		place_in_index(index);
+		return;
+	}
+	update_index();
+}
+
+[[nodiscard]]
+bool Object::wants_index(void) const noexcept
+{
+	switch (storage_)
+	{
+	case ObjectStorage::automatic:
+		return values_.size() >= hashed_object_threshold;
+	case ObjectStorage::sorted:
+		return false;
+	case ObjectStorage::hashed:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void Object::update_index(void)
+{
+	slots_.clear();
+	if (!wants_index() || values_.empty())
+	{
+		return;
+	}
+
+	std::size_t slot_count = 2;
+	while (slot_count < 2 * values_.size())
+	{
+		slot_count *= 2;
+	}
+	slots_.resize(slot_count);
+
+	for (std::size_t i = 0; i < values_.size(); ++i)
+	{
+		place_in_index(i);
+	}
+}
+
+void Object::place_in_index(std::size_t index) noexcept
+{
+	auto const mask = slots_.size() - 1;
+	auto slot = detail::mix_hash(hashes_[index]) & mask;
+	while (slots_[slot] != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+	slots_[slot] = static_cast<std::uint32_t>(index + 1);
+}
+
+static_assert(sizeof(Value) == 16);
+
+Value::Value(std::string str) : bytes_{}
+{
+	if (str.size() <= inline_capacity)
+	{
+		std::memcpy(bytes_, str.data(), str.size());
+		bytes_[tag_index] = static_cast<char>(str.size());
+		return;
+	}
+	set_node(std::move(str), long_string_tag);
+}
+
+Value::Value(char const* str) : Value(std::string(str)) {}
+
+Value::Value(List list) : bytes_{}
+{
+	set_node(std::move(list), list_tag);
+}
+
+Value::Value(Object object) : bytes_{}
+{
+	set_node(std::move(object), object_tag);
+}
+
+void Value::release_node(void) noexcept
+{
+	auto* const held = node();
+	if (held->references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	switch (tag())
+	{
+	case long_string_tag:
+		delete static_cast<detail::SharedNode<std::string>*>(held);
+		break;
+	case object_tag:
+		delete static_cast<detail::SharedNode<Object>*>(held);
+		break;
+	case list_tag:
+		delete static_cast<detail::SharedNode<List>*>(held);
+		break;
+	default:
+		break;
+	}
 }
 
 [[nodiscard]]
@@ -53,6 +359,17 @@ auto Value::property(std::string_view key) const noexcept -> MaybeValueReference
 	return as_object().property(key);
 }
 
+[[nodiscard]]
+auto Value::property(KeyHandle const& handle) const noexcept
+	-> MaybeValueReference
+{
+	if (!is_object())
+	{
+		return MaybeValueReference::empty();
+	}
+	return as_object().property(handle);
+}
+
 [[nodiscard]]
 auto Value::at(std::size_t index) const noexcept -> MaybeValueReference
 {
@@ -90,7 +407,31 @@ bool operator!=(Object const& a, Object const& b)
 [[nodiscard]]
 bool operator==(Value const& a, Value const& b)
 {
-	return a.value_ == b.value_;
+	// Strings that fit inline are never stored in a node.
+	if (a.tag() != b.tag())
+	{
+		return false;
+	}
+	if (a.tag() <= Value::inline_capacity)
+	{
+		return std::memcmp(a.bytes_, b.bytes_, a.tag()) == 0;
+	}
+	if (a.node() == b.node())
+	{
+		return true;
+	}
+
+	switch (a.tag())
+	{
+	case Value::long_string_tag:
+		return a.as_string() == b.as_string();
+	case Value::object_tag:
+		return a.as_object() == b.as_object();
+	case Value::list_tag:
+		return a.as_list() == b.as_list();
+	default:
+		return false;
+	}
 }
 
 [[nodiscard]]
@@ -0,0 +1,410 @@
+#include "jsonish/unescape.hpp"
+
+#include "jsonish/detail/chars.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace jsonish
+{
+using detail::is_ascii;
+using detail::is_disallowed_in_string;
+using detail::is_escapable;
+using detail::is_high_surrogate;
+using detail::is_low_surrogate;
+using detail::map_escaped_char;
+
+// This character ends a run of characters that can be copied verbatim.
+[[nodiscard]] static constexpr
+bool ends_run(char c) noexcept
+{
+	return c == '"' || c == '\\' || is_disallowed_in_string(c);
+}
+
+// Number of characters examined at once when looking for the end of a run.
+static constexpr std::size_t word_size = sizeof(std::uint64_t);
+
+// Produce a word with every byte set to `c`.
+[[nodiscard]] static constexpr
+std::uint64_t broadcast(unsigned char c) noexcept
+{
+	return 0x0101010101010101u * c;
+}
+
+/*
+ * Produce a nonzero value iff some byte in `word` is less than `n`, where `n`
+ * is at most 0x80. Only whether the result is zero is meaningful.
+ */
+[[nodiscard]] static constexpr
+std::uint64_t has_byte_less_than(std::uint64_t word, unsigned char n) noexcept
+{
+	return (word - broadcast(n)) & ~word & broadcast(0x80);
+}
+
+// Produce a nonzero value iff some byte in `word` is equal to `c`.
+[[nodiscard]] static constexpr
+std::uint64_t has_byte_equal_to(std::uint64_t word, unsigned char c) noexcept
+{
+	return has_byte_less_than(word ^ broadcast(c), 1);
+}
+
+/*
+ * Produce a nonzero value iff some byte in `word` ends a run. If
+ * `stop_at_non_ascii` is set, bytes outside of the ascii range also end a run.
+ */
+[[nodiscard]] static constexpr
+std::uint64_t has_run_end(std::uint64_t word, bool stop_at_non_ascii) noexcept
+{
+	auto const non_ascii = stop_at_non_ascii ? word & broadcast(0x80) : 0;
+	return has_byte_equal_to(word, '"')
+		| has_byte_equal_to(word, '\\')
+		| has_byte_less_than(word, 0x20)
+		| non_ascii;
+}
+
+/*
+ * Find the index of the first character at or after `pos` that ends a run. If
+ * there is no such character, produce the size of `chars`.
+ *
+ * Whole words are checked at once, and only the word containing the end of
+ * the run is examined one character at a time. If `Padded` is set, `chars` is
+ * followed by `unescape_padding` zero bytes. A zero byte ends a run, so the
+ * scan then stops at the end without checking for it.
+ */
+template <bool Padded>
+[[nodiscard]] static
+std::size_t find_run_end(
+	std::string_view chars, std::size_t pos, bool stop_at_non_ascii) noexcept
+{
+	auto const* const data = chars.data();
+	if constexpr (Padded)
+	{
+		// Two words are checked per iteration, which the padding allows.
+		while (true)
+		{
+			std::uint64_t words[2];
+			std::memcpy(words, data + pos, 2 * word_size);
+
+			if (has_run_end(words[0], stop_at_non_ascii) != 0)
+			{
+				break;
+			}
+			if (has_run_end(words[1], stop_at_non_ascii) != 0)
+			{
+				pos += word_size;
+				break;
+			}
+			pos += 2 * word_size;
+		}
+	}
+	else
+	{
+		while (chars.size() - pos >= word_size)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, data + pos, word_size);
+
+			if (has_run_end(word, stop_at_non_ascii) != 0)
+			{
+				break;
+			}
+			pos += word_size;
+		}
+	}
+
+	while ((Padded || pos < chars.size()) && !ends_run(data[pos])
+		&& !(stop_at_non_ascii && !is_ascii(data[pos])))
+	{
+		++pos;
+	}
+	return pos;
+}
+
+/*
+ * Produce the length of the valid UTF-8 sequence starting at `pos`, which must
+ * start with a non-ascii byte. If the sequence is invalid, overlong, encodes a
+ * surrogate, or is cut off, produce 0.
+ */
+[[nodiscard]] static
+std::size_t utf8_sequence_length(
+	std::string_view chars, std::size_t pos) noexcept
+{
+	auto const byte = [&](std::size_t i) {
+		return static_cast<unsigned char>(chars[pos + i]);
+	};
+
+	auto const lead = byte(0);
+	assert(lead >= 0x80);
+
+	// The range allowed for the second byte depends on the lead byte.
+	std::size_t length = 0;
+	unsigned char second_min = 0x80;
+	unsigned char second_max = 0xbf;
+	if (0xc2 <= lead && lead <= 0xdf)
+	{
+		length = 2;
+	}
+	else if (0xe0 <= lead && lead <= 0xef)
+	{
+		length = 3;
+		second_min = lead == 0xe0 ? 0xa0 : 0x80;
+		second_max = lead == 0xed ? 0x9f : 0xbf;
+	}
+	else if (0xf0 <= lead && lead <= 0xf4)
+	{
+		length = 4;
+		second_min = lead == 0xf0 ? 0x90 : 0x80;
+		second_max = lead == 0xf4 ? 0x8f : 0xbf;
+	}
+	else
+	{
+		return 0;
+	}
+
+	if (chars.size() - pos < length
+		|| byte(1) < second_min || second_max < byte(1))
+	{
+		return 0;
+	}
+	for (std::size_t i = 2; i < length; ++i)
+	{
+		if ((byte(i) & 0xc0) != 0x80)
+		{
+			return 0;
+		}
+	}
+	return length;
+}
+
+/*
+ * Decode the four hex digits starting at `pos` into a UTF-16 code unit and
+ * advance `pos` past them. If this fails, produce the reason and leave `pos`
+ * after the last character examined.
+ */
+static
+std::optional<ErrorCode> decode_code_unit(
+	std::string_view chars, std::size_t& pos, std::uint32_t& unit) noexcept
+{
+	unit = 0;
+	for (int i = 0; i < 4; ++i)
+	{
+		if (pos == chars.size())
+		{
+			return ErrorCode::no_closing_quote;
+		}
+
+		auto const digit = detail::hex_digit_value(chars[pos++]);
+		if (digit < 0)
+		{
+			return ErrorCode::expected_hex_digit;
+		}
+		unit = (unit << 4) | static_cast<std::uint32_t>(digit);
+	}
+	return std::nullopt;
+}
+
+/*
+ * If `high` is a high surrogate and is immediately followed by a '\u' escape
+ * containing a low surrogate, combine the two into a single code point and
+ * advance `pos` past the second escape. Otherwise, produce `high` unchanged.
+ */
+[[nodiscard]] static
+std::uint32_t combine_surrogates(
+	std::string_view chars, std::size_t& pos, std::uint32_t high) noexcept
+{
+	if (!is_high_surrogate(high) || chars.substr(pos, 2) != "\\u")
+	{
+		return high;
+	}
+
+	auto low_pos = pos + 2;
+	std::uint32_t low;
+	if (decode_code_unit(chars, low_pos, low) || !is_low_surrogate(low))
+	{
+		return high;
+	}
+
+	pos = low_pos;
+	return detail::combine_surrogates(high, low);
+}
+
+// Push the code point `code_point` into `out` as utf-8.
+template <typename Out>
+static
+void push_unicode_as_utf8(Out& out, std::uint32_t code_point)
+{
+	detail::encode_utf8(code_point, [&out](char c) { out.push_back(c); });
+}
+
+// Get the number of bytes `code_point` takes in utf-8.
+[[nodiscard]] static constexpr
+std::size_t utf8_length(std::uint32_t code_point) noexcept
+{
+	return code_point < 0x80 ? 1
+		: code_point < 0x800 ? 2
+		: code_point < 0x10000 ? 3
+		: 4;
+}
+
+/*
+ * Find the end of the run starting at `pos`, checking that any non-ascii
+ * characters in it form valid UTF-8 if `validate_utf8` is set. If they do not,
+ * produce the index of the first invalid byte and set `invalid` to true.
+ */
+template <bool Padded>
+[[nodiscard]] static
+std::size_t scan_run(
+	std::string_view chars,
+	std::size_t pos,
+	bool validate_utf8,
+	bool& invalid) noexcept
+{
+	invalid = false;
+	while (true)
+	{
+		pos = find_run_end<Padded>(chars, pos, validate_utf8);
+		if (pos == chars.size() || is_ascii(chars[pos]))
+		{
+			return pos;
+		}
+
+		auto const length = utf8_sequence_length(chars, pos);
+		if (length == 0)
+		{
+			invalid = true;
+			return pos;
+		}
+		pos += length;
+	}
+}
+
+/*
+ * Decode a string into `out`, which needs `append(char const*, std::size_t)`
+ * for runs of characters and `push_back(char)` for escaped characters.
+ * Decoding stops once more than `max_length` bytes are produced, which is
+ * checked before each run, so an escape may pass the limit by a few bytes.
+ */
+template <bool Padded, typename Out>
+static
+UnescapeResult decode_string(
+	std::string_view chars,
+	Out& out,
+	bool validate_utf8,
+	std::size_t max_length)
+{
+	std::size_t pos = 0;
+	std::size_t length = 0;
+	while (true)
+	{
+		bool invalid_utf8;
+		auto const run_end =
+			scan_run<Padded>(chars, pos, validate_utf8, invalid_utf8);
+		if (length > max_length || run_end - pos > max_length - length)
+		{
+			return {pos, ErrorCode::string_too_long};
+		}
+		out.append(chars.data() + pos, run_end - pos);
+		length += run_end - pos;
+		pos = run_end;
+
+		if (invalid_utf8)
+		{
+			return {pos + 1, ErrorCode::invalid_utf8};
+		}
+
+		if (pos == chars.size())
+		{
+			return {pos, ErrorCode::no_closing_quote};
+		}
+
+		char const c = chars[pos++];
+		if (c == '"')
+		{
+			return {pos, std::nullopt};
+		}
+		if (c != '\\')
+		{
+			return {pos, ErrorCode::invalid_character_in_string};
+		}
+
+		if (pos == chars.size())
+		{
+			return {pos, ErrorCode::no_closing_quote};
+		}
+
+		char const escaped = chars[pos++];
+		if (!is_escapable(escaped))
+		{
+			return {pos, ErrorCode::invalid_escape_sequence};
+		}
+		if (escaped != 'u')
+		{
+			out.push_back(map_escaped_char(escaped));
+			++length;
+			continue;
+		}
+
+		std::uint32_t unit;
+		if (auto const error = decode_code_unit(chars, pos, unit))
+		{
+			return {pos, *error};
+		}
+
+		auto const code_point = combine_surrogates(chars, pos, unit);
+		if (validate_utf8
+			&& (is_high_surrogate(code_point)
+				|| is_low_surrogate(code_point)))
+		{
+			return {pos, ErrorCode::unpaired_surrogate};
+		}
+		push_unicode_as_utf8(out, code_point);
+		length += utf8_length(code_point);
+	}
+}
+
+UnescapeResult unescape_string(
+	std::string_view chars,
+	std::string& out,
+	bool validate_utf8,
+	std::size_t max_length)
+{
+	return decode_string<false>(chars, out, validate_utf8, max_length);
+}
+
+UnescapeResult unescape_padded_string(
+	std::string_view chars,
+	std::string& out,
+	bool validate_utf8,
+	std::size_t max_length)
+{
+	return decode_string<true>(chars, out, validate_utf8, max_length);
+}
+
+namespace
+{
+/*
+ * Discards decoded characters. Only escaped characters are pushed one at a
+ * time, so that is how escapes are noticed.
+ */
+struct EscapeDetector
+{
+	void append(char const*, std::size_t) noexcept {}
+	void push_back(char) noexcept { has_escapes = true; }
+
+	bool has_escapes = false;
+};
+} // namespace
+
+UnescapeResult scan_string(
+	std::string_view chars, bool validate_utf8, bool& has_escapes)
+{
+	EscapeDetector detector;
+	constexpr auto no_limit = std::numeric_limits<std::size_t>::max();
+	auto const result =
+		decode_string<false>(chars, detector, validate_utf8, no_limit);
+	has_escapes = detector.has_escapes;
+	return result;
+}
+} // namespace jsonish
@@ -0,0 +1,89 @@
+#ifndef JSH_UNESCAPE_HPP_INCLUDED
+#define JSH_UNESCAPE_HPP_INCLUDED
+
+#include "jsonish/result.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace jsonish
+{
+/// The outcome of decoding the contents of a string.
+struct UnescapeResult
+{
+	/** The number of characters read.
+	 *
+	 * On success, this includes the closing quote. On failure, it includes
+	 * every character up to and including the one that caused the error.
+	 */
+	std::size_t consumed;
+
+	/// The reason decoding failed, if it did.
+	std::optional<ErrorCode> error;
+};
+
+/** Decode the contents of a string and append them to `out`.
+ *
+ * `chars` must start immediately after the opening quote of a string.
+ * Characters are decoded up to the first unescaped '"'. Runs of characters
+ * between escape sequences are copied in bulk, and surrogate pairs in '\\u'
+ * escapes are combined into a single code point.
+ *
+ * If `validate_utf8` is set, raw characters must form valid UTF-8 and lone
+ * surrogates are rejected. Otherwise, any byte other than a control character
+ * is accepted, and a lone surrogate is encoded as if it were a valid code
+ * point.
+ *
+ * Decoding fails with `ErrorCode::string_too_long` once more than
+ * `max_length` bytes are decoded. Runs of characters that would pass the
+ * limit are not appended, and at most one escape sequence is decoded past
+ * it, so a long string is not copied whole before it is rejected.
+ */
+UnescapeResult unescape_string(
+	std::string_view chars,
+	std::string& out,
+	bool validate_utf8 = false,
+	std::size_t max_length = std::numeric_limits<std::size_t>::max());
+
+/// The number of zero bytes `unescape_padded_string` needs after its input.
+inline constexpr std::size_t unescape_padding = 16;
+
+/** Like `unescape_string`, but without checking for the end of `chars` on
+ * every character.
+ *
+ * `chars` must be followed by at least `unescape_padding` readable zero bytes,
+ * as provided by a `PaddedString`.
+ */
+UnescapeResult unescape_padded_string(
+	std::string_view chars,
+	std::string& out,
+	bool validate_utf8 = false,
+	std::size_t max_length = std::numeric_limits<std::size_t>::max());
+
+/** Check the contents of a string without decoding them.
+ *
+ * This accepts exactly the strings `unescape_string` accepts and reports the
+ * same errors. `has_escapes` is set to whether any escape sequence was found,
+ * that is, whether the contents differ from the raw characters.
+ */
+UnescapeResult scan_string(
+	std::string_view chars, bool validate_utf8, bool& has_escapes);
+
+/** Get the most characters, including the closing quote, that the contents
+ * of a string decoding to at most `length` bytes can take.
+ *
+ * An escape sequence takes at most six characters for each byte it decodes
+ * to, so longer contents can be rejected without being decoded.
+ */
+[[nodiscard]] inline constexpr
+std::size_t max_escaped_length(std::size_t length) noexcept
+{
+	constexpr auto max = std::numeric_limits<std::size_t>::max();
+	return length > (max - 1) / 6 ? max : 6 * length + 1;
+}
+} // namespace jsonish
+
+#endif
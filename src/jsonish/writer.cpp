@@ -0,0 +1,328 @@
+#include "jsonish/writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace jsonish
+{
+/*
+ * Write all of `pieces` to `fd`, retrying after partial writes. Where
+ * scatter-gather writes are available, every piece is written at once.
+ */
+static
+void write_all(int fd, std::string_view (&pieces)[2])
+{
+	std::size_t first = 0;
+	while (first < 2)
+	{
+		if (pieces[first].empty())
+		{
+			++first;
+			continue;
+		}
+
+#ifdef _WIN32
+		auto const piece = pieces[first];
+		auto const written = ::_write(
+			fd, piece.data(),
+			static_cast<unsigned int>(std::min<std::size_t>(
+				piece.size(), 1u << 30)));
+#else
+		iovec vectors[2];
+		int count = 0;
+		for (auto i = first; i < 2; ++i)
+		{
+			vectors[count].iov_base = const_cast<char*>(pieces[i].data());
+			vectors[count].iov_len = pieces[i].size();
+			++count;
+		}
+		auto const written = ::writev(fd, vectors, count);
+#endif
+		if (written < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			throw std::system_error(
+				errno, std::generic_category(), "jsonish::Writer");
+		}
+
+		auto remaining = static_cast<std::size_t>(written);
+		for (; first < 2 && remaining >= pieces[first].size(); ++first)
+		{
+			remaining -= pieces[first].size();
+		}
+		if (first < 2)
+		{
+			pieces[first].remove_prefix(remaining);
+		}
+	}
+}
+
+Writer::Writer(int fd, std::size_t chunk_size) :
+	fd_(fd), chunk_size_(chunk_size == 0 ? 1 : chunk_size)
+{
+	buffer_.reserve(chunk_size_);
+}
+
+Writer::~Writer(void)
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		// Nothing can be reported from a destructor.
+	}
+}
+
+Writer& Writer::begin_object(void)
+{
+	begin_value();
+	write('{');
+	open_.push_back(Container::object);
+	at_first_item_ = true;
+	return *this;
+}
+
+Writer& Writer::end_object(void)
+{
+	end_container(Container::object);
+	return *this;
+}
+
+Writer& Writer::begin_list(void)
+{
+	begin_value();
+	write('[');
+	open_.push_back(Container::list);
+	at_first_item_ = true;
+	return *this;
+}
+
+Writer& Writer::end_list(void)
+{
+	end_container(Container::list);
+	return *this;
+}
+
+Writer& Writer::key(std::string_view key)
+{
+	if (open_.empty() || open_.back() != Container::object || after_key_)
+	{
+		throw std::logic_error("jsonish::Writer: a key must be a member");
+	}
+	if (!at_first_item_)
+	{
+		write(',');
+	}
+	at_first_item_ = false;
+	after_key_ = true;
+
+	write_string(key);
+	write(':');
+	return *this;
+}
+
+Writer& Writer::string(std::string_view str)
+{
+	begin_value();
+	write_string(str);
+	end_value();
+	return *this;
+}
+
+Writer& Writer::value(Value const& value)
+{
+	if (value.is_string())
+	{
+		return string(value.as_string());
+	}
+	if (value.is_object())
+	{
+		begin_object();
+		for (auto const& [member_key, member_value] : value.as_object())
+		{
+			key(member_key);
+			this->value(member_value);
+		}
+		return end_object();
+	}
+	begin_list();
+	for (auto const& element : value.as_list())
+	{
+		this->value(element);
+	}
+	return end_list();
+}
+
+void Writer::flush(void)
+{
+	if (fd_ >= 0 && !buffer_.empty())
+	{
+		write_out({});
+	}
+}
+
+std::string Writer::take_output(void) noexcept
+{
+	auto output = std::move(buffer_);
+	buffer_.clear();
+	return output;
+}
+
+void Writer::begin_value(void)
+{
+	if (open_.empty())
+	{
+		if (done_)
+		{
+			throw std::logic_error(
+				"jsonish::Writer: a document holds one value");
+		}
+		return;
+	}
+
+	if (open_.back() == Container::object)
+	{
+		if (!after_key_)
+		{
+			throw std::logic_error(
+				"jsonish::Writer: a member needs a key");
+		}
+		after_key_ = false;
+		return;
+	}
+
+	if (!at_first_item_)
+	{
+		write(',');
+	}
+	at_first_item_ = false;
+}
+
+void Writer::end_value(void)
+{
+	if (open_.empty())
+	{
+		done_ = true;
+		flush();
+	}
+}
+
+void Writer::end_container(Container container)
+{
+	if (open_.empty() || open_.back() != container || after_key_)
+	{
+		throw std::logic_error(
+			"jsonish::Writer: no matching container to close");
+	}
+	write(container == Container::object ? '}' : ']');
+	open_.pop_back();
+
+	// The closed container was an item of its parent.
+	at_first_item_ = false;
+	end_value();
+}
+
+// The escape sequence for each character that needs one, or 0 if none does.
+static
+char short_escape(char c) noexcept
+{
+	switch (c)
+	{
+	case '"': return '"';
+	case '\\': return '\\';
+	case '\b': return 'b';
+	case '\f': return 'f';
+	case '\n': return 'n';
+	case '\r': return 'r';
+	case '\t': return 't';
+	default: return 0;
+	}
+}
+
+[[nodiscard]]
+static
+bool needs_escape(char c) noexcept
+{
+	return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+void Writer::write_string(std::string_view str)
+{
+	write('"');
+
+	std::size_t run_start = 0;
+	for (std::size_t i = 0; i < str.size(); ++i)
+	{
+		auto const c = str[i];
+		if (!needs_escape(c))
+		{
+			continue;
+		}
+		write(str.substr(run_start, i - run_start));
+		run_start = i + 1;
+
+		if (auto const escape = short_escape(c))
+		{
+			char const sequence[2] = {'\\', escape};
+			write(std::string_view(sequence, 2));
+			continue;
+		}
+		constexpr char hex[] = "0123456789abcdef";
+		auto const byte = static_cast<unsigned char>(c);
+		char const sequence[6] = {
+			'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xf]};
+		write(std::string_view(sequence, 6));
+	}
+	write(str.substr(run_start));
+
+	write('"');
+}
+
+void Writer::write(char c)
+{
+	if (fd_ >= 0 && buffer_.size() >= chunk_size_)
+	{
+		write_out({});
+	}
+	buffer_.push_back(c);
+}
+
+void Writer::write(std::string_view chars)
+{
+	if (fd_ < 0 || buffer_.size() + chars.size() < chunk_size_)
+	{
+		buffer_.append(chars);
+		return;
+	}
+
+	// Long runs are written from where they are rather than copied.
+	if (chars.size() >= chunk_size_ / 2)
+	{
+		write_out(chars);
+		return;
+	}
+	write_out({});
+	buffer_.append(chars);
+}
+
+void Writer::write_out(std::string_view chars)
+{
+	std::string_view pieces[2] = {buffer_, chars};
+	write_all(fd_, pieces);
+	buffer_.clear();
+}
+} // namespace jsonish
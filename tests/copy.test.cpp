@@ -0,0 +1,173 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/parse_into.hpp"
+#include "jsonish/schema.hpp"
+#include "jsonish/tree.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#ifndef JSONISH_COUNT_COPIES
+#error "these tests need the library built with JSONISH_COUNT_COPIES"
+#endif
+
+/*
+ * Count every allocation, so that copies of strings too long to be stored
+ * inline can be detected.
+ */
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* const pointer = std::malloc(size == 0 ? 1 : size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+// A document along with the number of strings it contains.
+struct Document
+{
+	std::string text;
+	std::size_t keys = 0;
+	std::size_t values = 0;
+};
+
+/*
+ * Build objects nested `depth` deep, each holding a few strings and a list.
+ * The shape of the document does not depend on `long_strings`, which only
+ * controls whether the strings are too long to be stored inline.
+ */
+Document make_document(int depth, bool long_strings)
+{
+	Document doc;
+	int counter = 0;
+	auto const string = [&]()
+	{
+		auto const n = std::to_string(counter++);
+		return '"' + (long_strings ? std::string(32, 'x') : "") + n + '"';
+	};
+
+	for (int i = 0; i < depth; ++i)
+	{
+		doc.text += "{" + string() + ": " + string() + ", " + string() + ": [";
+		doc.text += string() + ", " + string() + "], " + string() + ": ";
+		doc.keys += 3;
+		doc.values += 3;
+	}
+	doc.text += string();
+	doc.values += 1;
+	doc.text += std::string(static_cast<std::size_t>(depth), '}');
+	return doc;
+}
+
+struct Counts
+{
+	std::size_t value_copies;
+	std::size_t allocations;
+};
+
+// Count copies and allocations made by `f`.
+template <typename F>
+Counts count(F&& f)
+{
+	auto const copies_before = jsonish::detail::value_copies.load();
+	auto const allocations_before = allocations.load();
+	f();
+	return Counts{
+		jsonish::detail::value_copies.load() - copies_before,
+		allocations.load() - allocations_before};
+}
+} // namespace
+
+TEST_CASE("Parse without copying values", "[copy]")
+{
+	auto const doc = make_document(50, true);
+
+	jsonish::Value value;
+	auto const counts =
+		count([&]() { value = jsonish::parse(doc.text).value(); });
+	REQUIRE(counts.value_copies == 0);
+	REQUIRE(value.is_object());
+
+	auto const into_counts = count([&]()
+	{
+		value = jsonish::parse_into<jsonish::Value>(doc.text).value();
+	});
+	REQUIRE(into_counts.value_copies == 0);
+
+	jsonish::Schema const schema(
+		{{"x0", jsonish::ValueKind::string},
+		 {"y", jsonish::ValueKind::object}});
+	auto const schema_counts = count([&]()
+	{
+		auto record = jsonish::parse(
+			R"({"x0": "a string longer than fifteen bytes",)"
+			R"( "y": {"z": ["a", "b"]}})",
+			schema);
+		REQUIRE(record.is_valid());
+	});
+	REQUIRE(schema_counts.value_copies == 0);
+}
+
+TEST_CASE("Parse without copying strings", "[copy]")
+{
+	/*
+	 * Parsing the same shape with short and long strings allocates the same
+	 * containers. Each long string should add one allocation for its text,
+	 * plus one for the node of a string value. Any copy of a string would
+	 * add another.
+	 */
+	auto const short_doc = make_document(20, false);
+	auto const long_doc = make_document(20, true);
+
+	auto const short_counts =
+		count([&]() { (void)jsonish::parse(short_doc.text).value(); });
+	auto const long_counts =
+		count([&]() { (void)jsonish::parse(long_doc.text).value(); });
+
+	REQUIRE(short_counts.value_copies == 0);
+	REQUIRE(long_counts.value_copies == 0);
+	REQUIRE(
+		long_counts.allocations - short_counts.allocations
+			== long_doc.keys + 2 * long_doc.values);
+}
+
+TEST_CASE("Reuse a parser's buffers", "[copy]")
+{
+	/*
+	 * Once a parser has seen a document, parsing it again allocates only
+	 * the tree: for each object its node, members and key hashes, and for
+	 * each list its node and elements. The strings are all stored inline.
+	 */
+	auto const doc = make_document(20, false);
+
+	jsonish::Parser parser;
+	(void)parser.parse(doc.text).value();
+
+	auto const warm_counts =
+		count([&]() { (void)parser.parse(doc.text).value(); });
+	REQUIRE(warm_counts.value_copies == 0);
+	REQUIRE(warm_counts.allocations == 20 * 3 + 20 * 2);
+
+	auto const cold_counts =
+		count([&]() { (void)jsonish::parse(doc.text).value(); });
+	REQUIRE(cold_counts.allocations > warm_counts.allocations);
+}
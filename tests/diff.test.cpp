@@ -0,0 +1,168 @@
+#include "jsonish/diff.hpp"
+#include "jsonish/document.hpp"
+#include "jsonish/parse.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+static
+jsonish::Value parse_value(std::string_view str)
+{
+	auto result = jsonish::parse(str);
+	REQUIRE(result.is_valid());
+	return std::move(result).value();
+}
+
+TEST_CASE("Diff values", "[diff]")
+{
+	auto const v0 = parse_value(
+		R"({"a" : "x", "b" : ["y", "z"], "c" : {"d" : "e"}, "f" : "g"})");
+	auto const v1 = parse_value(
+		R"({"a" : "x", "b" : ["y"], "c" : {"d" : "w", "h" : []}, "i" : {}})");
+
+	REQUIRE(jsonish::diff(v0, v0).empty());
+	REQUIRE(jsonish::diff(v0, parse_value(R"({"f" : "g", "a" : "x",
+		"c" : {"d" : "e"}, "b" : ["y", "z"]})")).empty());
+
+	auto const p0 = jsonish::diff(v0, v1);
+	REQUIRE(p0.size() == 5);
+	REQUIRE(p0[0].kind == jsonish::ChangeKind::removed);
+	REQUIRE(p0[0].path == jsonish::Path{"b", std::size_t(1)});
+	REQUIRE(p0[1].kind == jsonish::ChangeKind::changed);
+	REQUIRE(p0[1].path == jsonish::Path{"c", "d"});
+	REQUIRE(p0[1].value == "w");
+	REQUIRE(p0[2].kind == jsonish::ChangeKind::added);
+	REQUIRE(p0[2].path == jsonish::Path{"c", "h"});
+	REQUIRE(p0[3].kind == jsonish::ChangeKind::removed);
+	REQUIRE(p0[3].path == jsonish::Path{"f"});
+	REQUIRE(p0[4].kind == jsonish::ChangeKind::added);
+	REQUIRE(p0[4].path == jsonish::Path{"i"});
+	REQUIRE(jsonish::apply(p0, v0) == v1);
+	REQUIRE(jsonish::apply(jsonish::diff(v1, v0), v1) == v0);
+
+	// Values of different kinds are replaced whole.
+	auto const p1 = jsonish::diff(v0, parse_value(R"(["a"])"));
+	REQUIRE(p1.size() == 1);
+	REQUIRE(p1[0].kind == jsonish::ChangeKind::changed);
+	REQUIRE(p1[0].path.empty());
+
+	// Lists are compared index by index.
+	auto const l0 = parse_value(R"(["a", "b"])");
+	auto const l1 = parse_value(R"(["c", "a", "b"])");
+	auto const p2 = jsonish::diff(l0, l1);
+	REQUIRE(p2.size() == 3);
+	REQUIRE(p2[2].kind == jsonish::ChangeKind::added);
+	REQUIRE(p2[2].path == jsonish::Path{std::size_t(2)});
+	REQUIRE(jsonish::apply(p2, l0) == l1);
+	REQUIRE(jsonish::apply(jsonish::diff(l1, l0), l1) == l0);
+}
+
+TEST_CASE("Skip shared subtrees when diffing", "[diff]")
+{
+	std::string text = R"({"a" : [)";
+	for (int i = 0; i < 1000; ++i)
+	{
+		text += i == 0 ? "" : ", ";
+		text += R"({"b" : "c"})";
+	}
+	text += R"(], "d" : {"e" : "f"}})";
+
+	jsonish::Document document(text);
+	auto const before = document.value();
+	REQUIRE(document.edit(text.rfind('f'), 1, "g"));
+	auto const after = document.value();
+
+	auto const p0 = jsonish::diff(before, after);
+	REQUIRE(p0.size() == 1);
+	REQUIRE(p0[0].path == jsonish::Path{"d", "e"});
+
+	// Applying a patch copies only the containers along its paths.
+	auto const patched = jsonish::apply(p0, before);
+	REQUIRE(patched == after);
+	REQUIRE(
+		patched.property("a").as_value().shares_storage_with(
+			before.property("a").as_value()));
+	REQUIRE(
+		!patched.property("d").as_value().shares_storage_with(
+			before.property("d").as_value()));
+}
+
+TEST_CASE("Reject patches that do not apply", "[diff]")
+{
+	auto const v0 = parse_value(R"({"a" : ["b"], "c" : "d"})");
+	auto const change = [](
+		jsonish::ChangeKind kind, jsonish::Path path, jsonish::Value value)
+	{
+		return jsonish::Patch{jsonish::Change{
+			kind, std::move(path), std::move(value)}};
+	};
+	using jsonish::ChangeKind;
+
+	REQUIRE_THROWS_AS(
+		jsonish::apply(change(ChangeKind::removed, {"x"}, {}), v0),
+		std::invalid_argument);
+	REQUIRE_THROWS_AS(
+		jsonish::apply(change(ChangeKind::added, {"c"}, "e"), v0),
+		std::invalid_argument);
+	REQUIRE_THROWS_AS(
+		jsonish::apply(change(ChangeKind::changed, {"c", "x"}, "e"), v0),
+		std::invalid_argument);
+	REQUIRE_THROWS_AS(
+		jsonish::apply(
+			change(ChangeKind::changed, {"a", std::size_t(1)}, "e"), v0),
+		std::invalid_argument);
+	REQUIRE_THROWS_AS(
+		jsonish::apply(change(ChangeKind::removed, {}, {}), v0),
+		std::invalid_argument);
+
+	auto const v1 = jsonish::apply(
+		change(ChangeKind::added, {"a", std::size_t(1)}, "e"), v0);
+	REQUIRE(v1 == parse_value(R"({"a" : ["b", "e"], "c" : "d"})"));
+}
+
+// Build a small random value from a limited set of keys and strings.
+static
+jsonish::Value random_value(std::mt19937& random, int depth)
+{
+	auto const pick = [&](std::size_t bound)
+	{
+		return std::uniform_int_distribution<std::size_t>(0, bound)(random);
+	};
+
+	auto const kind = depth == 0 ? 0 : pick(2);
+	if (kind == 0)
+	{
+		return jsonish::Value(std::string(1 + pick(20), "abc"[pick(2)]));
+	}
+	if (kind == 1)
+	{
+		jsonish::List list;
+		for (auto i = pick(4); i > 0; --i)
+		{
+			list.append(random_value(random, depth - 1));
+		}
+		return jsonish::Value(std::move(list));
+	}
+	jsonish::Object object;
+	for (auto i = pick(4); i > 0; --i)
+	{
+		object.set_property(
+			std::string(1, "pqrst"[pick(4)]), random_value(random, depth - 1));
+	}
+	return jsonish::Value(std::move(object));
+}
+
+TEST_CASE("Diff and apply random values", "[diff]")
+{
+	std::mt19937 random(54321);
+	for (int i = 0; i < 500; ++i)
+	{
+		auto const from = random_value(random, 4);
+		auto const to = random_value(random, 4);
+		REQUIRE(jsonish::apply(jsonish::diff(from, to), from) == to);
+		REQUIRE(jsonish::diff(to, to).empty());
+	}
+}
@@ -0,0 +1,114 @@
+#include "jsonish/document.hpp"
+#include "jsonish/parse.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <string>
+
+// Check that a document agrees with parsing its text from scratch.
+static
+void require_matches_full_parse(jsonish::Document const& document)
+{
+	auto const expected = jsonish::parse(document.text());
+	REQUIRE(document.is_valid() == expected.is_valid());
+	if (expected.is_valid())
+	{
+		REQUIRE(document.value() == expected.value());
+	}
+	else
+	{
+		REQUIRE(document.errors()[0].code == expected.errors()[0].code);
+	}
+}
+
+TEST_CASE("Edit documents", "[document]")
+{
+	jsonish::Document d0(
+		R"({"a" : ["x", {"b" : "y"}], "c" : {"d" : ["z"]}, "e" : []})");
+	REQUIRE(d0.is_valid());
+	REQUIRE(d0.last_parsed_size() == d0.text().size());
+	auto const v0 = d0.value();
+
+	// Only the innermost container around the edit is parsed again.
+	REQUIRE(d0.edit(22, 0, "y"));
+	REQUIRE(d0.last_parsed_size() == 12);
+	REQUIRE(d0.value().property("a").at(1).property("b").as_string() == "yy");
+	require_matches_full_parse(d0);
+
+	// Containers away from the edit are shared with the previous value.
+	REQUIRE(
+		&d0.value().property("c").as_value().as_object()
+			== &v0.property("c").as_value().as_object());
+	REQUIRE(v0.property("a").at(1).property("b").as_string() == "y");
+
+	REQUIRE(d0.edit(46, 0, R"(, "w" : "")"));
+	REQUIRE(d0.last_parsed_size() == 23);
+	REQUIRE(d0.value().property("c").property("w").exists());
+	require_matches_full_parse(d0);
+
+	// An edit that unbalances a container parses the whole document.
+	REQUIRE(!d0.edit(45, 1, ""));
+	REQUIRE(d0.last_parsed_size() == d0.text().size());
+	REQUIRE(!d0.errors().empty());
+	REQUIRE(d0.value().property("c").property("w").exists());
+	require_matches_full_parse(d0);
+
+	REQUIRE(d0.edit(45, 0, "]"));
+	require_matches_full_parse(d0);
+
+	// So does an edit to the outermost braces.
+	REQUIRE(d0.edit(0, 1, "{ "));
+	REQUIRE(d0.last_parsed_size() == d0.text().size());
+	require_matches_full_parse(d0);
+
+	REQUIRE_THROWS_AS(d0.edit(d0.text().size(), 1, ""), std::out_of_range);
+
+	jsonish::Document d1(R"("just a string")");
+	REQUIRE(d1.edit(1, 4, "not"));
+	REQUIRE(d1.value().as_string() == "not a string");
+}
+
+TEST_CASE("Edit documents at random", "[document]")
+{
+	std::mt19937 random(12345);
+	auto const pick = [&](std::size_t bound)
+	{
+		return std::uniform_int_distribution<std::size_t>(0, bound)(random);
+	};
+
+	std::string const pieces[] = {
+		"[", "]", "{", "}", ",", ":", " ", "\"a\"", "\"b\" : ", "[\"c\"]",
+		"{\"d\" : \"e\"}", "\"", "\\", "\"x\", ", "\"y\" : [], ", "z"};
+
+	/*
+	 * Most random edits make the text invalid, so those are undone to keep
+	 * editing valid text.
+	 */
+	jsonish::Document document(
+		R"({"a" : [{"b" : ["c", "d"]}, {"e" : {}}], "f" : [[], [[]]]})");
+	std::size_t incremental = 0;
+	for (int i = 0; i < 2000; ++i)
+	{
+		auto const offset = pick(document.text().size());
+		auto const removed = pick(std::min<std::size_t>(
+			2, document.text().size() - offset));
+		auto const inserted =
+			pick(2) == 0 ? std::string() : pieces[pick(std::size(pieces) - 1)];
+		std::string const old(document.text().substr(offset, removed));
+
+		auto const valid = document.edit(offset, removed, inserted);
+		require_matches_full_parse(document);
+		if (valid && document.last_parsed_size() < document.text().size())
+		{
+			++incremental;
+		}
+		if (!valid)
+		{
+			REQUIRE(document.edit(offset, inserted.size(), old));
+			require_matches_full_parse(document);
+		}
+	}
+	REQUIRE(incremental > 100);
+}
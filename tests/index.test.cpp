@@ -0,0 +1,80 @@
+#include "jsonish/index.hpp"
+#include "jsonish/parse.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+
+static
+jsonish::Value parse_value(std::string_view str)
+{
+	auto result = jsonish::parse(str);
+	REQUIRE(result.is_valid());
+	return std::move(result).value();
+}
+
+TEST_CASE("Find elements through an index", "[index]")
+{
+	auto const records = parse_value(R"([
+		{"id" : "a", "owner" : {"name" : "x"}},
+		{"id" : "a long identifier", "owner" : {"name" : "y"}},
+		{"id" : ["not a string"]},
+		{"owner" : {"name" : "x"}},
+		"not an object",
+		{"id" : "b"}
+	])");
+
+	jsonish::Index const by_id(records, "id");
+	REQUIRE(by_id.size() == 3);
+	REQUIRE(by_id.position("a") == 0);
+	REQUIRE(by_id.position("a long identifier") == 1);
+	REQUIRE(by_id.position("b") == 5);
+	REQUIRE(by_id.find("b").as_value() == parse_value(R"({"id" : "b"})"));
+	REQUIRE(!by_id.find("c").exists());
+	REQUIRE(!by_id.position("not a string"));
+
+	// Several indexes share one list, and the first of equal keys is found.
+	jsonish::Index const by_owner(records, jsonish::Path{"owner", "name"});
+	REQUIRE(&by_owner.list() == &by_id.list());
+	REQUIRE(by_owner.size() == 2);
+	REQUIRE(by_owner.position("x") == 0);
+	REQUIRE(by_owner.position("y") == 1);
+
+	jsonish::Index const strings(
+		parse_value(R"(["p", "q", ["r"]])"), jsonish::Path());
+	REQUIRE(strings.position("q") == 1);
+	REQUIRE(!strings.position("r"));
+
+	jsonish::Index const empty(parse_value("[]"), "id");
+	REQUIRE(empty.size() == 0);
+	REQUIRE(!empty.find("a").exists());
+
+	REQUIRE_THROWS_AS(
+		jsonish::Index(parse_value("{}"), "id"), std::invalid_argument);
+}
+
+TEST_CASE("Build an index with several threads", "[index]")
+{
+	jsonish::List list;
+	for (int i = 0; i < 50000; ++i)
+	{
+		jsonish::Object record;
+		record.set_property("id", "record " + std::to_string(i % 40000));
+		list.append(jsonish::Value(std::move(record)));
+	}
+	jsonish::Value const records(std::move(list));
+
+	for (std::size_t thread_count : {1, 4, 0})
+	{
+		jsonish::Index const index(records, "id", thread_count);
+		REQUIRE(index.size() == 40000);
+		for (int i = 0; i < 40000; i += 997)
+		{
+			REQUIRE(
+				index.position("record " + std::to_string(i))
+					== std::size_t(i));
+		}
+		REQUIRE(!index.position("record 40000"));
+	}
+}
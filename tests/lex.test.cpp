@@ -1,7 +1,12 @@
 #include "jsonish/lex.hpp"
+#include "jsonish/unescape.hpp"
 
 #include <catch2/catch.hpp>
 
+#include <string>
+#include <string_view>
+#include <utility>
+
 TEST_CASE("Extract tokens", "[lex]")
 {
 	jsonish::Lexer l0(R"({ ["one string", "two string"] :[{}]}   )");
@@ -87,6 +92,38 @@ TEST_CASE("Correctly store strings", "[lex]")
 
 	jsonish::Lexer l1(R"("\u221E\u0020\u00ac\u00ac\u6570")");
 	REQUIRE(l1.extract_token().text() == "∞ ¬¬数");
+
+	// Surrogate pairs are combined into one code point.
+	jsonish::Lexer l2(R"("\ud83d\ude00 and \uD834\uDD1E")");
+	REQUIRE(l2.extract_token().text() == "😀 and 𝄞");
+
+	// Lone surrogates are encoded as if they were code points.
+	jsonish::Lexer l3(R"("\ud83d" "\ude00\ud83d" "\ud83d\n")");
+	REQUIRE(l3.extract_token().text() == "\xed\xa0\xbd");
+	REQUIRE(
+		l3.extract_token().text() == "\xed\xb8\x80\xed\xa0\xbd");
+	REQUIRE(l3.extract_token().text() == "\xed\xa0\xbd\n");
+
+	// Runs longer than a word between escapes are copied intact.
+	jsonish::Lexer l4(
+		R"("a fairly long run of text\tthen another one \"quoted\"")");
+	REQUIRE(
+		l4.extract_token().text()
+			== "a fairly long run of text\tthen another one \"quoted\"");
+
+	// Raw non-ascii characters are copied as is.
+	jsonish::Lexer l5("\"∞ ¬¬数 \\u00ac\"");
+	REQUIRE(l5.extract_token().text() == "∞ ¬¬数 ¬");
+
+	jsonish::Lexer l6(R"("\ud83d\uzzzz")");
+	REQUIRE(
+		l6.extract_token().error()
+			== jsonish::ErrorCode::expected_hex_digit);
+
+	jsonish::Lexer l7(R"("abcdefghijklmnop\u12)");
+	REQUIRE(
+		l7.extract_token().error()
+			== jsonish::ErrorCode::no_closing_quote);
 }
 
 TEST_CASE("Peek tokens", "[lex]")
@@ -133,3 +170,87 @@ TEST_CASE("Peek tokens", "[lex]")
 	REQUIRE(!l2.next_is(jsonish::TokenType::rbracket));
 	REQUIRE(!l2.next_is(jsonish::TokenType::eof));
 }
+
+TEST_CASE("Validate utf-8 in strings", "[lex]")
+{
+	jsonish::ParseOptions strict;
+	strict.validate_utf8 = true;
+
+	jsonish::Lexer l0(
+		"\"∞ ¬¬数 😀 and some ascii after it\" \"\\ud83d\\ude00\"",
+		strict);
+	REQUIRE(
+		l0.extract_token().text() == "∞ ¬¬数 😀 and some ascii after it");
+	REQUIRE(l0.extract_token().text() == "😀");
+
+	// Overlong encoding of '/'.
+	jsonish::Lexer l1("\"abc\xc0\xaf\"", strict);
+	REQUIRE(l1.extract_token().error() == jsonish::ErrorCode::invalid_utf8);
+
+	// Encoded surrogate.
+	jsonish::Lexer l2("\"\xed\xa0\xbd\"", strict);
+	REQUIRE(l2.extract_token().error() == jsonish::ErrorCode::invalid_utf8);
+
+	// Truncated sequence, then a stray continuation byte.
+	jsonish::Lexer l3a("\"\xe2\x88\"", strict);
+	REQUIRE(l3a.extract_token().error() == jsonish::ErrorCode::invalid_utf8);
+	jsonish::Lexer l3b("\"a long ascii prefix\x80\"", strict);
+	REQUIRE(l3b.extract_token().error() == jsonish::ErrorCode::invalid_utf8);
+
+	// Code point above U+10FFFF.
+	jsonish::Lexer l4("\"\xf4\x90\x80\x80\"", strict);
+	REQUIRE(l4.extract_token().error() == jsonish::ErrorCode::invalid_utf8);
+
+	jsonish::Lexer l5a(R"("\ud83d")", strict);
+	REQUIRE(
+		l5a.extract_token().error()
+			== jsonish::ErrorCode::unpaired_surrogate);
+	jsonish::Lexer l5b(R"("\ude00\ud83d")", strict);
+	REQUIRE(
+		l5b.extract_token().error()
+			== jsonish::ErrorCode::unpaired_surrogate);
+
+	// Without validation, the same bytes are accepted.
+	jsonish::Lexer l6("\"abc\xc0\xaf\" \"\xe2\x88\"");
+	REQUIRE(l6.extract_token().text() == "abc\xc0\xaf");
+	REQUIRE(l6.extract_token().text() == "\xe2\x88");
+}
+
+TEST_CASE("Stop decoding strings at their limit", "[lex]")
+{
+	jsonish::ParseOptions options;
+	options.limits.max_string_length = 4;
+
+	// Escapes count as the bytes they decode to.
+	std::pair<std::string, bool> const strings[] = {
+		{R"("abcd")", true},
+		{R"("ab\n\n")", true},
+		{R"("ab\u00e9")", true},
+		{R"("abcde")", false},
+		{R"("abc\n\n")", false},
+		{R"("abc\u00e9")", false},
+	};
+	for (auto const& [text, accepted] : strings)
+	{
+		jsonish::PaddedString const padded{std::string_view(text)};
+		for (auto lex :
+			{jsonish::Lexer(text, options), jsonish::Lexer(padded, options)})
+		{
+			auto const token = lex.extract_token();
+			if (accepted)
+			{
+				REQUIRE(token.type() == jsonish::TokenType::string);
+				continue;
+			}
+			REQUIRE(token.error() == jsonish::ErrorCode::string_too_long);
+			REQUIRE(token.position().offset == 0);
+		}
+	}
+
+	// Nothing past the limit is copied.
+	std::string const huge(1 << 20, 'a');
+	std::string out;
+	auto const result = jsonish::unescape_string(huge, out, false, 100);
+	REQUIRE(result.error == jsonish::ErrorCode::string_too_long);
+	REQUIRE(out.empty());
+}
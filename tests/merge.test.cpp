@@ -0,0 +1,95 @@
+#include "jsonish/merge.hpp"
+#include "jsonish/parse.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+static
+jsonish::Value parse_value(std::string_view str)
+{
+	auto result = jsonish::parse(str);
+	REQUIRE(result.is_valid());
+	return std::move(result).value();
+}
+
+TEST_CASE("Merge layers", "[merge]")
+{
+	auto const defaults = parse_value(R"({
+		"log" : {"level" : "info", "file" : "app.log"},
+		"hosts" : ["a", "b"],
+		"limits" : {"cpu" : "1", "memory" : "1G"},
+		"name" : "app"
+	})");
+	auto const region = parse_value(R"({
+		"log" : {"level" : "debug"},
+		"hosts" : ["c"],
+		"zone" : "eu"
+	})");
+	auto const host = parse_value(R"({"log" : {"file" : "host.log"}})");
+
+	auto const merged = jsonish::merge({defaults, region, host});
+	REQUIRE(merged == parse_value(R"({
+		"log" : {"level" : "debug", "file" : "host.log"},
+		"hosts" : ["c"],
+		"limits" : {"cpu" : "1", "memory" : "1G"},
+		"name" : "app",
+		"zone" : "eu"
+	})"));
+
+	// Subtrees that only one layer provides are shared, not copied.
+	REQUIRE(
+		merged.property("limits").as_value().shares_storage_with(
+			defaults.property("limits").as_value()));
+	REQUIRE(
+		merged.property("hosts").as_value().shares_storage_with(
+			region.property("hosts").as_value()));
+
+	// An object that overrides nothing leaves the layer below it as it is.
+	auto const empty = parse_value("{}");
+	REQUIRE(jsonish::merge({defaults, empty}).shares_storage_with(defaults));
+	REQUIRE(jsonish::merge({defaults, defaults}).shares_storage_with(defaults));
+	REQUIRE(
+		jsonish::merge({defaults, parse_value(R"({"name" : "app"})")})
+			.shares_storage_with(defaults));
+
+	// Anything but an object replaces what is below it, and vice versa.
+	REQUIRE(jsonish::merge({defaults, "x"}) == "x");
+	REQUIRE(jsonish::merge({defaults, "x", host}) == host);
+	REQUIRE(jsonish::merge({defaults}).shares_storage_with(defaults));
+
+	REQUIRE_THROWS_AS(
+		jsonish::merge(std::vector<jsonish::Value>()), std::invalid_argument);
+}
+
+TEST_CASE("Look up values through an overlay", "[merge]")
+{
+	jsonish::Overlay const overlay({
+		parse_value(R"({"a" : {"b" : "c", "d" : ["e"]}, "f" : "g"})"),
+		parse_value(R"({"a" : {"b" : "h"}, "f" : {"i" : "j"}})"),
+		parse_value(R"({"a" : {"d" : ["k", "l"]}})")});
+
+	REQUIRE(overlay.property("a").property("b").value() == "h");
+	REQUIRE(overlay.property("a").property("d").at(1).value() == "l");
+	REQUIRE(overlay.property("f").property("i").value() == "j");
+	REQUIRE(overlay.property("a").property("b").layers().size() == 2);
+
+	REQUIRE(!overlay.property("x").exists());
+	REQUIRE(!overlay.property("a").property("b").property("c").exists());
+	REQUIRE(!overlay.property("a").property("d").at(2).exists());
+	REQUIRE_THROWS_AS(
+		overlay.property("x").value(), std::bad_optional_access);
+
+	// A value that is not an object hides the layers below it.
+	jsonish::Overlay const replaced({
+		parse_value(R"({"a" : {"b" : "c"}})"),
+		parse_value(R"({"a" : ["d"]})"),
+		parse_value(R"({"a" : {"e" : "f"}})")});
+	REQUIRE(!replaced.property("a").property("b").exists());
+	REQUIRE(replaced.property("a").property("e").value() == "f");
+
+	REQUIRE(overlay.value() == jsonish::merge(overlay.layers()));
+}
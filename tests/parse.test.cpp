@@ -5,7 +5,11 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
 
 TEST_CASE("Parse jsonish", "[parse]")
 {
@@ -130,3 +134,232 @@ TEST_CASE("Parse jsonish", "[parse]")
 		REQUIRE(!v11.at(1).at(2).property("thing").exists());
 	}
 }
+
+TEST_CASE("Report parse errors", "[parse]")
+{
+	auto r0 = jsonish::parse(R"({"key" : "value", "key" : "other"})");
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors().size() == 1);
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r0.errors()[0].position.offset == 18);
+	REQUIRE(r0.errors()[0].reason() == "key already defined");
+
+	auto r1 = jsonish::parse("[\n  \"one\",\n  two\n]");
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors().size() == 2);
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::expected_value);
+	REQUIRE(r1.errors()[1].code == jsonish::ErrorCode::unexpected_character);
+	REQUIRE(
+		r1.errors()[1].message()
+			== "unexpected character at line 3, column 3");
+
+	auto r2 = jsonish::parse(R"(["one"] "two")");
+	REQUIRE(!r2.is_valid());
+	REQUIRE(r2.errors().size() == 1);
+	REQUIRE(
+		r2.errors()[0].code == jsonish::ErrorCode::trailing_characters);
+	REQUIRE(
+		r2.errors()[0].message()
+			== "garbage at end of input at line 1, column 9");
+
+	// Keys are checked once the object is read, but the first repetition is
+	// still reported.
+	auto r3 = jsonish::parse(R"({"b" : "", "a" : "", "b" : "", "a" : ""})");
+	REQUIRE(!r3.is_valid());
+	REQUIRE(r3.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r3.errors()[0].position.offset == 21);
+
+	// Members of nested objects do not disturb the positions of the keys.
+	char const* const nested[][2] = {
+		{R"({"x" : {"y" : "1"}, "a" : "1", "a" : "2"})", "a"},
+		{R"({"x" : {"b" : "1", "a" : "2", "b" : "3"}})", "b"},
+		{R"({"x" : [{"y" : "1"}, {"z" : "2"}], "a" : "1", "a" : "2"})", "a"},
+		{R"([{"x" : {"y" : ""}}, {"a" : "", "b" : "", "a" : ""}])", "a"},
+	};
+	for (auto const& [text, key] : nested)
+	{
+		auto const r4 = jsonish::parse(text);
+		REQUIRE(!r4.is_valid());
+		REQUIRE(r4.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+		auto const expected = std::string_view(text).rfind(
+			std::string("\"") + key + "\"");
+		REQUIRE(r4.errors()[0].position.offset == expected);
+	}
+
+	// A repeated key is reported before a later error in the same object.
+	auto const r5 = jsonish::parse(R"({"a" : "1", "a" : "2", ])");
+	REQUIRE(r5.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r5.errors()[0].position.offset == 12);
+	auto const r6 = jsonish::parse(R"({"a" : "1", "a" : "2", "b" : [}})");
+	REQUIRE(r6.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r6.errors()[0].position.offset == 12);
+
+	auto const r8 =
+		jsonish::parse(R"({"a" : "", "a" : "", "x" : {"b" : "", "b" : ""}})");
+	REQUIRE(r8.errors()[0].code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r8.errors()[0].position.offset == 11);
+
+	// But not before an earlier one.
+	auto const r7 = jsonish::parse(R"({"a" : [}], "a" : "2"})");
+	REQUIRE(r7.errors()[0].code == jsonish::ErrorCode::expected_value);
+}
+
+TEST_CASE("Parse objects with a chosen storage", "[parse]")
+{
+	jsonish::ParseOptions options;
+	options.object_storage = jsonish::ObjectStorage::hashed;
+
+	auto const v0 =
+		jsonish::parse(R"({"b" : {}, "a" : {"c" : ""}})", options).value();
+	REQUIRE(v0.as_object().is_hashed());
+	REQUIRE(v0.property("a").as_object().is_hashed());
+	REQUIRE(v0.property("a").property("c").exists());
+
+	options.object_storage = jsonish::ObjectStorage::sorted;
+	auto const v1 =
+		jsonish::parse(R"({"b" : {}, "a" : {"c" : ""}})", options).value();
+	REQUIRE(!v1.as_object().is_hashed());
+	REQUIRE(v0 == v1);
+}
+
+TEST_CASE("Parse with utf-8 validation", "[parse]")
+{
+	jsonish::ParseOptions strict;
+	strict.validate_utf8 = true;
+
+	auto r0 = jsonish::parse("{\"clé\" : [\"värde\", \"\\u00e9\"]}", strict);
+	REQUIRE(r0.is_valid());
+	REQUIRE(r0.value().property("clé").at(1).as_string() == "é");
+
+	auto r1 = jsonish::parse("{\"key\" : [\"ok\", \"\xff\"]}", strict);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors().back().code == jsonish::ErrorCode::invalid_utf8);
+
+	REQUIRE(jsonish::parse("{\"key\" : [\"ok\", \"\xff\"]}").is_valid());
+}
+
+TEST_CASE("Parse padded strings", "[parse]")
+{
+	jsonish::PaddedString const empty;
+	REQUIRE(empty.size() == 0);
+	REQUIRE(empty.data()[0] == '\0');
+
+	jsonish::PaddedString p0(std::string_view(R"({"a" : ["b"]})"));
+	auto const p1 = p0;
+	REQUIRE(p1.view() == p0.view());
+	REQUIRE(p1.data() != p0.data());
+	REQUIRE(p1.data()[p1.size()] == '\0');
+
+	// A moved-from string is empty, and parses as such.
+	auto moved = p0;
+	auto const taken = std::move(moved);
+	REQUIRE(taken.view() == p0.view());
+	REQUIRE(moved.size() == 0);
+	REQUIRE(moved.view().empty());
+	REQUIRE(
+		jsonish::parse(moved).errors()[0].code
+			== jsonish::ErrorCode::expected_value);
+	moved = std::move(p0);
+	REQUIRE(moved.view() == taken.view());
+	REQUIRE(p0.size() == 0);
+
+	// Padded and unpadded parsing agree, including on errors.
+	char const* const inputs[] = {
+		R"({"a" : ["b", "c"], "d" : {}})",
+		"  [ \"a long string without any escapes\" ]  \n",
+		R"(["escapes \n é 😀"])",
+		R"("unterminated)",
+		R"(["a long unterminated string that spans several words)",
+		R"("unterminated escape \)",
+		R"("cut off \u12)",
+		"\"control \x01 character\"",
+		R"(["a", b])",
+		R"(["a"] "trailing")",
+		"   ",
+		"",
+	};
+	for (auto const* input : inputs)
+	{
+		jsonish::PaddedString const padded{std::string_view(input)};
+		auto const expected = jsonish::parse(std::string_view(input));
+		auto const actual = jsonish::parse(padded);
+
+		REQUIRE(actual.is_valid() == expected.is_valid());
+		if (expected.is_valid())
+		{
+			REQUIRE(actual.value() == expected.value());
+			continue;
+		}
+		REQUIRE(actual.errors().size() == expected.errors().size());
+		for (std::size_t i = 0; i < expected.errors().size(); ++i)
+		{
+			REQUIRE(actual.errors()[i].code == expected.errors()[i].code);
+			REQUIRE(
+				actual.errors()[i].position.offset
+					== expected.errors()[i].position.offset);
+		}
+	}
+
+	// A string may be written in place before parsing.
+	jsonish::PaddedString p2(std::size_t{4});
+	std::memcpy(p2.data(), R"("ok")", 4);
+	REQUIRE(jsonish::parse(p2).value().as_string() == "ok");
+}
+
+TEST_CASE("Reuse a parser", "[parse]")
+{
+	jsonish::Parser parser;
+
+	char const* const inputs[] = {
+		R"({"b" : ["x", "y"], "a" : {"d" : "", "c" : ["z"]}})",
+		R"({"b" : "", "a" : "", "b" : "", "a" : ""})",
+		R"([["a", {"c" : "", "b" : ""}], ["b"]])",
+		R"([["a", {"c" : "", "b" : [})",
+		R"({"k" : {"j" : "", "i" : ""}, "h" : ["g"]})",
+		R"(["a"] "trailing")",
+		R"({"b" : "", "a" : ""})",
+	};
+
+	// A parser gives the same results as parsing afresh, even after errors.
+	for (auto const* const input : inputs)
+	{
+		auto const fresh = jsonish::parse(input);
+		auto const reused = parser.parse(input);
+		REQUIRE(fresh.is_valid() == reused.is_valid());
+		if (fresh.is_valid())
+		{
+			REQUIRE(fresh.value() == reused.value());
+		}
+		else
+		{
+			REQUIRE(fresh.errors().size() == reused.errors().size());
+			REQUIRE(fresh.errors()[0].code == reused.errors()[0].code);
+			REQUIRE(
+				fresh.errors()[0].position.offset
+					== reused.errors()[0].position.offset);
+		}
+	}
+
+	auto const v0 = parser.parse(inputs[0]).value();
+	REQUIRE(v0.property("a").property("c").at(0).as_string() == "z");
+	REQUIRE(v0.property("b").at(1).as_string() == "y");
+
+	parser.release_memory();
+	REQUIRE(parser.parse(inputs[0]).value() == v0);
+
+	jsonish::ParseOptions options;
+	options.object_storage = jsonish::ObjectStorage::hashed;
+	jsonish::Parser hashing(options);
+	REQUIRE(hashing.options().object_storage == options.object_storage);
+	REQUIRE(hashing.parse(inputs[0]).value().as_object().is_hashed());
+
+	// A moved-from parser starts again with its options.
+	auto moved = std::move(hashing);
+	REQUIRE(moved.parse(inputs[0]).value() == v0);
+	REQUIRE(hashing.options().object_storage == options.object_storage);
+	REQUIRE(hashing.parse(inputs[0]).value().as_object().is_hashed());
+	hashing.release_memory();
+	hashing = std::move(moved);
+	moved.release_memory();
+	REQUIRE(moved.parse(inputs[0]).value() == v0);
+}
@@ -0,0 +1,68 @@
+#include "jsonish/parse_async.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+TEST_CASE("Parse asynchronously", "[parse_async]")
+{
+	auto f0 = jsonish::parse_async(R"({"a" : ["b", "c"]})");
+	REQUIRE(f0.get().value().property("a").at(1).as_string() == "c");
+
+	// Tasks can be held by the executor and run later.
+	std::vector<std::function<void()>> queue;
+	jsonish::Executor const enqueue = [&](std::function<void()> task)
+	{
+		queue.push_back(std::move(task));
+	};
+
+	auto f1 = jsonish::parse_async(R"(["a", b])", enqueue);
+	REQUIRE(queue.size() == 1);
+	queue.back()();
+	auto const r1 = f1.get();
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::expected_value);
+
+	// Errors outlive the document, which the task owned.
+	REQUIRE(
+		r1.errors()[0].message() == "expected string, '{', or '[' at offset 6");
+
+	jsonish::ParseOptions options;
+	options.object_storage = jsonish::ObjectStorage::hashed;
+	auto const run_now = [](std::function<void()> task) { task(); };
+	auto f2 = jsonish::parse_async(R"({"a" : ""})", run_now, options);
+	REQUIRE(f2.get().value().as_object().is_hashed());
+}
+
+TEST_CASE("Cancel parsing", "[parse_async]")
+{
+	std::vector<std::function<void()>> queue;
+	jsonish::Executor const enqueue = [&](std::function<void()> task)
+	{
+		queue.push_back(std::move(task));
+	};
+
+	jsonish::CancellationToken token;
+	auto f0 = jsonish::parse_async(
+		R"({"a" : ["b", "c"]})", enqueue, {}, token);
+	token.cancel();
+	REQUIRE(token.is_cancelled());
+	queue.back()();
+
+	auto const r0 = f0.get();
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors().size() == 1);
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::cancelled);
+	REQUIRE(r0.errors()[0].position.offset == 0);
+
+	// Cancellation is only checked as containers start.
+	jsonish::Parser parser;
+	REQUIRE(parser.parse(R"("a string")", token).is_valid());
+	REQUIRE(parser.parse(R"(["a string"])").is_valid());
+
+	// The same parser can carry on without the token.
+	jsonish::CancellationToken const other;
+	REQUIRE(parser.parse(R"([["a"], {}])", other).is_valid());
+}
@@ -0,0 +1,94 @@
+#include "jsonish/parse_async.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef JSONISH_HAS_COROUTINES
+#error "these tests need a compiler with coroutines"
+#endif
+
+namespace
+{
+// A coroutine that starts at once and is never awaited itself.
+struct Task
+{
+	struct promise_type
+	{
+		Task get_return_object(void) noexcept { return {}; }
+		std::suspend_never initial_suspend(void) noexcept { return {}; }
+		std::suspend_never final_suspend(void) noexcept { return {}; }
+		void return_void(void) noexcept {}
+		void unhandled_exception(void) noexcept { std::terminate(); }
+	};
+};
+
+// Await a parse of `text` on `executor`, then fulfil `promise` with it.
+Task await_parse(
+	std::string text,
+	jsonish::Executor executor,
+	std::promise<jsonish::Result<jsonish::Value>>& promise)
+{
+	promise.set_value(
+		co_await jsonish::parse_awaitable(
+			std::move(text), std::move(executor)));
+}
+}
+
+TEST_CASE("Await a parse", "[parse_async]")
+{
+	/*
+	 * The executor may run the parse, and resume the coroutine, at once. It
+	 * uses its own state after the coroutine has finished with the
+	 * awaitable.
+	 */
+	auto const count = std::make_shared<int>(0);
+	std::promise<jsonish::Result<jsonish::Value>> p0;
+	auto f0 = p0.get_future();
+	await_parse(
+		R"({"a" : ["b"]})",
+		[count](std::function<void()> task)
+		{
+			task();
+			++*count;
+		},
+		p0);
+	REQUIRE(*count == 1);
+	REQUIRE(f0.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+	REQUIRE(f0.get().value().property("a").at(0).as_string() == "b");
+
+	// Or hold it to run later.
+	std::vector<std::function<void()>> queue;
+	std::promise<jsonish::Result<jsonish::Value>> p1;
+	auto f1 = p1.get_future();
+	await_parse(
+		R"(["a", b])",
+		[&queue](std::function<void()> task)
+		{
+			queue.push_back(std::move(task));
+		},
+		p1);
+	REQUIRE(queue.size() == 1);
+	queue.back()();
+	auto const r1 = f1.get();
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::expected_value);
+	REQUIRE(
+		r1.errors()[0].message() == "expected string, '{', or '[' at offset 6");
+
+	// Or run it on another thread.
+	for (int i = 0; i < 100; ++i)
+	{
+		std::promise<jsonish::Result<jsonish::Value>> p2;
+		auto f2 = p2.get_future();
+		await_parse(R"(["c"])", jsonish::run_on_new_thread, p2);
+		REQUIRE(f2.get().value().at(0).as_string() == "c");
+	}
+}
@@ -0,0 +1,169 @@
+#include "jsonish/parse_into.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+struct Window
+{
+	std::string title;
+	std::vector<std::string> tags;
+};
+
+struct Config
+{
+	std::string name;
+	std::optional<std::string> theme;
+	std::vector<Window> windows;
+	std::map<std::string, std::string> env;
+	std::optional<jsonish::Value> extra;
+};
+} // namespace
+
+JSONISH_DESCRIBE(Window,
+	JSONISH_MEMBER(Window, title),
+	JSONISH_MEMBER(Window, tags));
+
+JSONISH_DESCRIBE(Config,
+	JSONISH_MEMBER(Config, name),
+	JSONISH_MEMBER(Config, theme),
+	jsonish::member("windows", &Config::windows),
+	jsonish::member("environment", &Config::env),
+	JSONISH_MEMBER(Config, extra));
+
+TEST_CASE("Parse into described structs", "[parse_into]")
+{
+	auto r0 = jsonish::parse_into<Config>(R"({
+		"name" : "main",
+		"windows" : [
+			{"title" : "one", "tags" : []},
+			{"tags" : ["a", "b"], "title" : "two"}
+		],
+		"environment" : {"HOME" : "/root", "LANG" : "C"},
+		"unknown" : {"nested" : ["ignored", {}]},
+		"extra" : ["kept", {"as" : "tree"}]
+	})");
+	REQUIRE(r0.is_valid());
+	auto const& c0 = r0.value();
+	REQUIRE(c0.name == "main");
+	REQUIRE(!c0.theme.has_value());
+	REQUIRE(c0.windows.size() == 2);
+	REQUIRE(c0.windows[0].title == "one");
+	REQUIRE(c0.windows[0].tags.empty());
+	REQUIRE(c0.windows[1].title == "two");
+	REQUIRE(c0.windows[1].tags == std::vector<std::string>{"a", "b"});
+	REQUIRE(c0.env.size() == 2);
+	REQUIRE(c0.env.at("HOME") == "/root");
+	REQUIRE(c0.extra.has_value());
+	REQUIRE(c0.extra->at(1).property("as").as_string() == "tree");
+
+	auto r1 = jsonish::parse_into<Config>(
+		R"({"name" : "n", "theme" : "dark", "windows" : [],)"
+		R"( "environment" : {}})");
+	REQUIRE(r1.is_valid());
+	REQUIRE(r1.value().theme == "dark");
+
+	auto r2 = jsonish::parse_into<std::vector<std::string>>(
+		R"(["one", "two"])");
+	REQUIRE(r2.is_valid());
+	REQUIRE(r2.value() == std::vector<std::string>{"one", "two"});
+
+	// Unknown members are skipped without recursion.
+	auto const deep = std::string(100000, '[') + std::string(100000, ']');
+	auto const r3 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : [], "other" : )" + deep + "}");
+	REQUIRE(r3.is_valid());
+	REQUIRE(r3.value().title == "a");
+}
+
+TEST_CASE("Report errors when parsing into structs", "[parse_into]")
+{
+	// Missing "environment".
+	auto r0 = jsonish::parse_into<Config>(
+		R"({"name" : "n", "windows" : []})");
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors().back().code == jsonish::ErrorCode::missing_member);
+
+	auto r1 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : [], "title" : "b"})");
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors().back().code == jsonish::ErrorCode::duplicate_key);
+	REQUIRE(r1.errors().back().position.offset == 29);
+
+	auto r2 = jsonish::parse_into<Window>(R"({"title" : [], "tags" : []})");
+	REQUIRE(!r2.is_valid());
+	REQUIRE(
+		r2.errors().front().code == jsonish::ErrorCode::expected_string);
+
+	// Unknown members are still validated.
+	auto r3 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : [], "other" : [}]})");
+	REQUIRE(!r3.is_valid());
+	REQUIRE(
+		r3.errors().front().code == jsonish::ErrorCode::expected_value);
+
+	auto r4 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : ["x",]})");
+	REQUIRE(!r4.is_valid());
+
+	auto r5 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : []} [])");
+	REQUIRE(!r5.is_valid());
+	REQUIRE(
+		r5.errors().front().code
+			== jsonish::ErrorCode::trailing_characters);
+
+	auto r6 = jsonish::parse_into<std::map<std::string, std::string>>(
+		R"({"a" : "1", "a" : "2"})");
+	REQUIRE(!r6.is_valid());
+	REQUIRE(r6.errors().back().code == jsonish::ErrorCode::duplicate_key);
+}
+
+TEST_CASE("Apply limits when parsing into structs", "[parse_into]")
+{
+	jsonish::ParseOptions options;
+	options.limits.max_depth = 10;
+
+	// Far deeper than a recursive reader could go without a limit.
+	auto const deep = std::string(100000, '[') + std::string(100000, ']');
+	auto const skipped = R"({"title" : "a", "tags" : [], "other" : )";
+	auto const r0 = jsonish::parse_into<Window>(
+		skipped + deep + "}", options);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(
+		r0.errors()[0].position.offset
+			== std::string_view(skipped).size() + 9);
+
+	auto const read = R"({"extra" : )";
+	auto const r1 = jsonish::parse_into<Config>(read + deep + "}", options);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(
+		r1.errors()[0].position.offset
+			== std::string_view(read).size() + 9);
+
+	options.limits.max_depth = 1;
+	using Nested = std::vector<std::vector<std::string>>;
+	REQUIRE(jsonish::parse_into<std::vector<std::string>>("[]", options)
+		.is_valid());
+	auto const r2 = jsonish::parse_into<Nested>("[[]]", options);
+	REQUIRE(!r2.is_valid());
+	REQUIRE(r2.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r2.errors()[0].position.offset == 1);
+
+	options = {};
+	options.limits.max_input_bytes = 10;
+	auto const r3 = jsonish::parse_into<Window>(
+		R"({"title" : "a", "tags" : []})", options);
+	REQUIRE(!r3.is_valid());
+	REQUIRE(r3.errors().size() == 1);
+	REQUIRE(r3.errors()[0].code == jsonish::ErrorCode::input_too_large);
+	REQUIRE(r3.errors()[0].position.offset == 10);
+}
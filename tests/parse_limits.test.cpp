@@ -0,0 +1,161 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/projection.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+namespace
+{
+// Parse `text` with the given limits.
+jsonish::Result<jsonish::Value> parse_limited(
+	std::string const& text, jsonish::ParseLimits const& limits)
+{
+	jsonish::ParseOptions options;
+	options.limits = limits;
+	return jsonish::parse(text, options);
+}
+}
+
+TEST_CASE("Limit the size of the input", "[parse_limits]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_input_bytes = 10;
+	REQUIRE(parse_limited(R"(["abcdef"])", limits).is_valid());
+
+	auto const r0 = parse_limited(R"(["abcdefg"])", limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors().size() == 1);
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::input_too_large);
+	REQUIRE(r0.errors()[0].position.offset == 10);
+}
+
+TEST_CASE("Limit the depth of nesting", "[parse_limits]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_depth = 3;
+	REQUIRE(parse_limited(R"([{"a" : []}])", limits).is_valid());
+	REQUIRE(parse_limited(R"("a")", limits).is_valid());
+
+	auto const r0 = parse_limited(R"([{"a" : [[]]}])", limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r0.errors()[0].position.offset == 9);
+
+	// Far deeper than a recursive parser could go without a limit.
+	auto const deep = std::string(100000, '[') + std::string(100000, ']');
+	limits.max_depth = 100;
+	auto const r1 = parse_limited(deep, limits);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r1.errors()[0].position.offset == 100);
+}
+
+TEST_CASE("Limit the length of strings", "[parse_limits]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_string_length = 3;
+	REQUIRE(parse_limited(R"({"abc" : ["éx"]})", limits).is_valid());
+
+	// The limit is on decoded strings, so escapes count once.
+	REQUIRE(parse_limited(R"(["\n\n\n"])", limits).is_valid());
+
+	auto const r0 = parse_limited(R"(["abcd"])", limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[1].code == jsonish::ErrorCode::string_too_long);
+	REQUIRE(r0.errors()[1].position.offset == 1);
+
+	auto const r1 = parse_limited(R"({"abcd" : "a"})", limits);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[1].code == jsonish::ErrorCode::string_too_long);
+}
+
+TEST_CASE("Limit the number of values", "[parse_limits]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_nodes = 4;
+	REQUIRE(parse_limited(R"([{"a" : "b"}, "c"])", limits).is_valid());
+
+	auto const r0 = parse_limited(R"([{"a" : "b"}, "c", "d"])", limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_many_nodes);
+	REQUIRE(r0.errors()[0].position.offset == 19);
+
+	auto const r1 = parse_limited(R"([[], [], [], []])", limits);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::too_many_nodes);
+}
+
+TEST_CASE("Limit the number of members", "[parse_limits]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_members = 2;
+	REQUIRE(
+		parse_limited(R"({"a" : {"b" : "", "c" : ""}, "d" : ""})", limits)
+			.is_valid());
+
+	auto const r0 = parse_limited(R"({"a" : "", "b" : "", "c" : ""})", limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_many_members);
+	REQUIRE(r0.errors()[0].position.offset == 21);
+}
+
+TEST_CASE("Limit the memory of the tree", "[parse_limits]")
+{
+	std::string text = "[";
+	for (int i = 0; i < 1000; ++i)
+	{
+		text += i == 0 ? "" : ", ";
+		text += R"({"name" : "a string too long to be stored inline"})";
+	}
+	text += "]";
+
+	jsonish::ParseLimits limits;
+	limits.max_allocated_bytes = 1000 * 100;
+	auto const r0 = parse_limited(text, limits);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_much_memory);
+
+	limits.max_allocated_bytes = 1000 * 1000;
+	REQUIRE(parse_limited(text, limits).is_valid());
+}
+
+TEST_CASE("Keep limits when reusing a parser", "[parse_limits]")
+{
+	jsonish::ParseOptions options;
+	options.limits.max_depth = 2;
+	options.limits.max_nodes = 3;
+	jsonish::Parser parser(options);
+
+	// Each parse is counted from the start.
+	for (int i = 0; i < 3; ++i)
+	{
+		REQUIRE(parser.parse(R"([["a"]])").is_valid());
+		REQUIRE(
+			parser.parse(R"([[[]]])").errors()[0].code
+			== jsonish::ErrorCode::too_deep);
+		REQUIRE(
+			parser.parse(R"([["a", "b"]])").errors()[0].code
+			== jsonish::ErrorCode::too_many_nodes);
+	}
+}
+
+TEST_CASE("Limit values skipped by a projection", "[parse_limits]")
+{
+	jsonish::Projection const first({jsonish::Path{std::size_t(0)}});
+	jsonish::ParseOptions options;
+	options.limits.max_depth = 3;
+	options.limits.max_nodes = 3;
+
+	// Skipped values are not built, so they are not counted as values.
+	auto const r0 = jsonish::parse(
+		R"([["a"], ["b", "c", "d"]])", first, options);
+	REQUIRE(r0.is_valid());
+	REQUIRE(r0.value() == jsonish::parse(R"([["a"]])").value());
+
+	// But their depth is still limited.
+	auto const r1 = jsonish::parse(R"([["a"], [[[]]]])", first, options);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r1.errors()[0].position.offset == 10);
+}
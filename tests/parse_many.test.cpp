@@ -0,0 +1,72 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/parse_many.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("Parse many documents", "[parse_many]")
+{
+	// Documents of very different sizes, some of them invalid.
+	std::vector<std::string> texts;
+	for (std::size_t i = 0; i < 200; ++i)
+	{
+		auto const n = std::to_string(i);
+		switch (i % 4)
+		{
+		case 0:
+			texts.push_back("[\"" + n + "\"]");
+			break;
+		case 1:
+			texts.push_back(R"({"b" : ")" + n + R"(", "a" : ["x"]})");
+			break;
+		case 2:
+			texts.push_back("[\"" + n + "\", invalid]");
+			break;
+		default:
+		{
+			std::string text = "[";
+			for (std::size_t j = 0; j < i * 10; ++j)
+			{
+				text += "{\"key\" : \"" + std::to_string(j) + "\"}, ";
+			}
+			texts.push_back(text + "\"" + n + "\"]");
+			break;
+		}
+		}
+	}
+	std::vector<std::string_view> const documents(
+		std::begin(texts), std::end(texts));
+
+	for (std::size_t const threads : {0, 1, 3, 500})
+	{
+		auto const results = jsonish::parse_many(documents, {}, threads);
+		REQUIRE(results.size() == documents.size());
+
+		// Results are in the order of the documents.
+		for (std::size_t i = 0; i < documents.size(); ++i)
+		{
+			auto const expected = jsonish::parse(documents[i]);
+			REQUIRE(results[i].is_valid() == expected.is_valid());
+			if (expected.is_valid())
+			{
+				REQUIRE(results[i].value() == expected.value());
+			}
+			else
+			{
+				REQUIRE(
+					results[i].errors()[0].code
+						== expected.errors()[0].code);
+			}
+		}
+	}
+
+	REQUIRE(jsonish::parse_many(std::vector<std::string_view>{}).empty());
+
+	jsonish::ParseOptions options;
+	options.object_storage = jsonish::ObjectStorage::hashed;
+	auto const hashed = jsonish::parse_many(documents, options, 2);
+	REQUIRE(hashed[1].value().as_object().is_hashed());
+}
@@ -0,0 +1,150 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/projection.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <random>
+#include <string>
+#include <vector>
+
+static
+jsonish::Value parse_value(std::string_view str)
+{
+	auto result = jsonish::parse(str);
+	REQUIRE(result.is_valid());
+	return std::move(result).value();
+}
+
+TEST_CASE("Parse selected paths", "[projection]")
+{
+	auto const text = R"({
+		"name" : "report",
+		"rows" : [{"id" : "a", "data" : ["x"]}, {"id" : "b\u00e9"}],
+		"meta" : {"owner" : "x", "tags" : ["p", "q"], "notes" : "\"n\""},
+		"big" : [[[{"deep" : "value"}]], "\n\t"]
+	})";
+
+	jsonish::Projection const p0({{"name"}, {"meta", "tags"}});
+	auto const r0 = jsonish::parse(text, p0);
+	REQUIRE(r0.is_valid());
+	REQUIRE(r0.value() == parse_value(
+		R"({"name" : "report", "meta" : {"tags" : ["p", "q"]}})"));
+
+	// Indices in paths are those of the input.
+	jsonish::Projection const p1({{"rows", std::size_t(1), "id"}});
+	REQUIRE(
+		jsonish::parse(text, p1).value()
+			== parse_value(R"({"rows" : [{"id" : "bé"}]})"));
+
+	// A path that leads nowhere leaves its containers empty.
+	jsonish::Projection const p2({{"meta", "missing"}, {"name", "x"}});
+	REQUIRE(
+		jsonish::parse(text, p2).value()
+			== parse_value(R"({"meta" : {}, "name" : "report"})"));
+
+	// A function can select, for example, one key of every element.
+	jsonish::Projection const ids(
+		[](jsonish::Path const& path)
+		{
+			if (path.size() < 3)
+			{
+				return path[0] == jsonish::PathElement("rows")
+					? jsonish::Selection::descend
+					: jsonish::Selection::skip;
+			}
+			return path[2] == jsonish::PathElement("id")
+				? jsonish::Selection::keep
+				: jsonish::Selection::skip;
+		});
+	REQUIRE(
+		jsonish::parse(text, ids).value()
+			== parse_value(R"({"rows" : [{"id" : "a"}, {"id" : "bé"}]})"));
+
+	// Selecting everything builds everything, and a string root is built.
+	jsonish::Projection const all({jsonish::Path()});
+	REQUIRE(jsonish::parse(text, all).value() == parse_value(text));
+	REQUIRE(jsonish::parse(R"("root")", p0).value() == "root");
+}
+
+TEST_CASE("Check skipped values", "[projection]")
+{
+	jsonish::Projection const none({});
+	auto const errors_match = [&](std::string_view text)
+	{
+		auto const projected = jsonish::parse(text, none);
+		auto const full = jsonish::parse(text);
+		REQUIRE(projected.is_valid() == full.is_valid());
+		if (!full.is_valid())
+		{
+			REQUIRE(projected.errors().size() == full.errors().size());
+			for (std::size_t i = 0; i < full.errors().size(); ++i)
+			{
+				REQUIRE(projected.errors()[i].code == full.errors()[i].code);
+				REQUIRE(
+					projected.errors()[i].position.offset
+						== full.errors()[i].position.offset);
+			}
+		}
+	};
+
+	errors_match(R"({"a" : [{"b" : "c"}, [], {}]})");
+	errors_match(R"({"a" : [{"b" "c"}]})");
+	errors_match(R"({"a" : [{"b" : "c",}]})");
+	errors_match(R"({"a" : [{b : "c"}]})");
+	errors_match(R"({"a" : ["b" "c"]})");
+	errors_match(R"({"a" : ["b", ]})");
+	errors_match(R"({"a" : ["b"})");
+	errors_match(R"({"a" : {"b" : "c"]})");
+	errors_match(R"({"a" : "\q"})");
+	errors_match(R"({"a" : "\u12"})");
+	errors_match(R"({"a" : [)");
+	errors_match(R"({"a" : "b"} x)");
+
+	// Keys repeated by skipped members are found.
+	errors_match(R"({"a" : "b", "c" : "d", "a" : "e"})");
+
+	jsonish::ParseOptions strict;
+	strict.validate_utf8 = true;
+	REQUIRE(
+		jsonish::parse("{\"a\" : \"\xc0\xaf\"}", none, strict).errors()[1].code
+			== jsonish::ErrorCode::invalid_utf8);
+}
+
+TEST_CASE("Check skipped values at random", "[projection]")
+{
+	std::mt19937 random(2468);
+	auto const pick = [&](std::size_t bound)
+	{
+		return std::uniform_int_distribution<std::size_t>(0, bound)(random);
+	};
+
+	std::string const pieces[] = {
+		"[", "]", "{", "}", ",", ":", " ", "\"a\"", "\"b\"", "\"\\n\"",
+		"\"\\u00e9\"", "x"};
+	jsonish::Projection const none({});
+	jsonish::Projection const one({{"a"}});
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		std::string text = "{\"a\" : ";
+		for (auto n = pick(12); n > 0; --n)
+		{
+			text += pieces[pick(std::size(pieces) - 1)];
+		}
+		text += pick(1) == 0 ? "}" : ", \"z\" : [\"y\"]}";
+
+		auto const full = jsonish::parse(text);
+		for (auto const* projection : {&none, &one})
+		{
+			auto const projected = jsonish::parse(text, *projection);
+			REQUIRE(projected.is_valid() == full.is_valid());
+			if (!full.is_valid())
+			{
+				REQUIRE(projected.errors()[0].code == full.errors()[0].code);
+				REQUIRE(
+					projected.errors()[0].position.offset
+						== full.errors()[0].position.offset);
+			}
+		}
+	}
+}
@@ -0,0 +1,253 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/pull_reader.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// Supplies a string a few characters at a time.
+class ChunkedSource : public jsonish::Source
+{
+public:
+	ChunkedSource(std::string_view chars, std::size_t chunk) :
+		chars_(chars), chunk_(chunk)
+	{}
+
+	std::size_t read(char* buffer, std::size_t size) override
+	{
+		auto const count = std::min({size, chunk_, chars_.size()});
+		chars_.copy(buffer, count);
+		chars_.remove_prefix(count);
+		return count;
+	}
+
+private:
+	std::string_view chars_;
+	std::size_t chunk_;
+};
+
+// Supplies a prefix and then one character forever, as a hostile peer might.
+class EndlessSource : public jsonish::Source
+{
+public:
+	EndlessSource(std::string_view prefix, char c) : prefix_(prefix), c_(c) {}
+
+	std::size_t read(char* buffer, std::size_t size) override
+	{
+		if (!prefix_.empty())
+		{
+			auto const count = prefix_.copy(buffer, size);
+			prefix_.remove_prefix(count);
+			return count;
+		}
+		std::fill_n(buffer, size, c_);
+		return size;
+	}
+
+private:
+	std::string_view prefix_;
+	char c_;
+};
+} // namespace
+
+TEST_CASE("Pull tokens from a source", "[pull_reader]")
+{
+	std::string const long_text(100, 'x');
+	auto const input = " {\"key\" :\n[\"" + long_text
+		+ "\", \"esc\\\"aped\\u00e9\" ] } ";
+
+	for (std::size_t const buffer_size : {1, 2, 7, 16, 1000})
+	{
+		ChunkedSource source(input, 3);
+		jsonish::PullReader reader(source, {}, buffer_size);
+
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::lbrace);
+		REQUIRE(reader.offset() == 1);
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::string);
+		REQUIRE(reader.text() == "key");
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::colon);
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::lbracket);
+		REQUIRE(reader.offset() == 10);
+		REQUIRE(reader.next());
+		REQUIRE(reader.text() == long_text);
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::comma);
+		REQUIRE(reader.next());
+		REQUIRE(reader.text() == "esc\"apedé");
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::rbracket);
+		REQUIRE(reader.next());
+		REQUIRE(reader.kind() == jsonish::TokenKind::rbrace);
+		REQUIRE(!reader.next());
+		REQUIRE(!reader.error());
+		REQUIRE(reader.offset() == input.size());
+		REQUIRE(!reader.next());
+	}
+
+	ChunkedSource s0("[\"bad \\q escape\"]", 4);
+	jsonish::PullReader r0(s0, {}, 4);
+	REQUIRE(r0.next());
+	REQUIRE(!r0.next());
+	REQUIRE(r0.error()->code == jsonish::ErrorCode::invalid_escape_sequence);
+	REQUIRE(r0.offset() == 1);
+	REQUIRE(!r0.next());
+}
+
+TEST_CASE("Parse from a source", "[pull_reader]")
+{
+	char const* const inputs[] = {
+		R"({"b" : ["x", "y"], "a" : {"d" : "", "c" : ["z"]}})",
+		R"({"b" : "", "a" : "", "b" : "", "a" : ""})",
+		R"(  [ "a long string that spans several buffers" , [] , {} ]  )",
+		R"(["a", b])",
+		R"(["a" "b"])",
+		R"({"a" "b"})",
+		R"({"a" : "b",})",
+		R"([)",
+		R"({)",
+		R"({"a")",
+		R"("unterminated)",
+		"\"control \x01 character\"",
+		R"(["a"] "trailing")",
+		R"(["a"] $)",
+		"   ",
+		"",
+	};
+
+	for (auto const* const input : inputs)
+	{
+		auto const expected = jsonish::parse(input);
+		for (std::size_t const buffer_size : {1, 5, 64})
+		{
+			ChunkedSource source(input, 2);
+			auto const result = jsonish::parse(source, {}, buffer_size);
+			REQUIRE(result.is_valid() == expected.is_valid());
+			if (expected.is_valid())
+			{
+				REQUIRE(result.value() == expected.value());
+				continue;
+			}
+			REQUIRE(result.errors().size() == expected.errors().size());
+			for (std::size_t i = 0; i < expected.errors().size(); ++i)
+			{
+				REQUIRE(result.errors()[i].code == expected.errors()[i].code);
+				REQUIRE(
+					result.errors()[i].position.offset
+						== expected.errors()[i].position.offset);
+			}
+		}
+	}
+
+	std::istringstream stream(R"({"from" : ["a", "stream"]})");
+	jsonish::StreamSource s0(stream);
+	REQUIRE(
+		jsonish::parse(s0).value().property("from").at(1).as_string()
+			== "stream");
+
+	jsonish::ParseOptions strict;
+	strict.validate_utf8 = true;
+	ChunkedSource s1("[\"\xff\"]", 1);
+	REQUIRE(
+		jsonish::parse(s1, strict).errors().back().code
+			== jsonish::ErrorCode::invalid_utf8);
+}
+
+TEST_CASE("Limit parsing from a source", "[pull_reader]")
+{
+	jsonish::ParseLimits limits;
+	limits.max_input_bytes = 48;
+	limits.max_depth = 3;
+	limits.max_string_length = 6;
+	limits.max_nodes = 6;
+	limits.max_members = 2;
+
+	char const* const inputs[] = {
+		R"({"a" : [["b"]], "c" : "d"})",
+		R"([[["a"]]])",
+		R"([[[[]]]])",
+		R"(["abcdef", "\u0061bcdef", "abcdefg"])",
+		R"(["\u0061\u0062\u0063\u0064\u0065\u0066\u0067"])",
+		R"(["a", "b", "c", "d", "e", "f"])",
+		R"({"a" : "", "b" : "", "c" : ""})",
+		R"([                                              ])",
+		R"([                                               ])",
+	};
+
+	jsonish::ParseOptions options;
+	options.limits = limits;
+	for (auto const* const input : inputs)
+	{
+		auto const expected = jsonish::parse(input, options);
+		for (std::size_t const buffer_size : {1, 5, 64})
+		{
+			ChunkedSource source(input, 3);
+			auto const result = jsonish::parse(source, options, buffer_size);
+			REQUIRE(result.is_valid() == expected.is_valid());
+			if (expected.is_valid())
+			{
+				REQUIRE(result.value() == expected.value());
+				continue;
+			}
+			REQUIRE(result.errors().size() == expected.errors().size());
+			for (std::size_t i = 0; i < expected.errors().size(); ++i)
+			{
+				REQUIRE(result.errors()[i].code == expected.errors()[i].code);
+				REQUIRE(
+					result.errors()[i].position.offset
+						== expected.errors()[i].position.offset);
+			}
+		}
+	}
+
+	// Endless input stops at the first limit it reaches.
+	options.limits = {};
+	options.limits.max_depth = 64;
+	EndlessSource s0("", '[');
+	auto const r0 = jsonish::parse(s0, options);
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r0.errors()[0].position.offset == 64);
+	REQUIRE(
+		r0.errors()[0].message()
+			== "containers are nested too deeply at offset 64");
+
+	options.limits.max_input_bytes = 1 << 20;
+	EndlessSource s1("", ' ');
+	auto const r1 = jsonish::parse(s1, options);
+	REQUIRE(r1.errors().size() == 1);
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::input_too_large);
+	REQUIRE(r1.errors()[0].position.offset == 1 << 20);
+
+	options.limits.max_input_bytes = jsonish::no_limit;
+	options.limits.max_string_length = 100;
+	EndlessSource s2("\"", 'a');
+	auto const r2 = jsonish::parse(s2, options, 16);
+	REQUIRE(r2.errors()[1].code == jsonish::ErrorCode::string_too_long);
+	REQUIRE(r2.errors()[1].position.offset == 0);
+}
+
+#ifndef _WIN32
+TEST_CASE("Parse from a file descriptor", "[pull_reader]")
+{
+	auto* const file = std::tmpfile();
+	REQUIRE(file != nullptr);
+	std::string const text = R"({"key" : ["from", "a", "file"]})";
+	std::fwrite(text.data(), 1, text.size(), file);
+	std::fflush(file);
+	std::rewind(file);
+
+	jsonish::FdSource source(fileno(file));
+	auto const value = jsonish::parse(source, {}, 8).value();
+	REQUIRE(value == jsonish::parse(text).value());
+	std::fclose(file);
+}
+#endif
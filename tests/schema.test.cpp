@@ -0,0 +1,122 @@
+#include "jsonish/schema.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <string_view>
+
+TEST_CASE("Look up schema keys", "[schema]")
+{
+	std::vector<jsonish::Field> fields;
+	for (int i = 0; i < 200; ++i)
+	{
+		fields.push_back(
+			{"key" + std::to_string(i), jsonish::ValueKind::string});
+	}
+	jsonish::Schema const schema(fields);
+
+	REQUIRE(schema.size() == 200);
+	for (std::size_t i = 0; i < 200; ++i)
+	{
+		REQUIRE(schema.index_of("key" + std::to_string(i)) == i);
+	}
+	REQUIRE(!schema.index_of("key200").has_value());
+	REQUIRE(!schema.index_of("").has_value());
+
+	jsonish::Schema const empty({});
+	REQUIRE(!empty.index_of("key").has_value());
+
+	REQUIRE_THROWS_AS(
+		jsonish::Schema({
+			{"a", jsonish::ValueKind::string},
+			{"a", jsonish::ValueKind::list}}),
+		std::invalid_argument);
+}
+
+TEST_CASE("Parse with a schema", "[schema]")
+{
+	jsonish::Schema const schema({
+		{"name", jsonish::ValueKind::string},
+		{"paths", jsonish::ValueKind::list},
+		{"env", jsonish::ValueKind::object, false},
+		{"theme", jsonish::ValueKind::string, false}});
+
+	auto r0 = jsonish::parse(
+		R"({"paths" : ["a", {}], "name" : "main", "env" : {"k" : "v"}})",
+		schema);
+	REQUIRE(r0.is_valid());
+	auto const& record = r0.value();
+	REQUIRE(record.size() == 4);
+	REQUIRE(record.field(0).as_string() == "main");
+	REQUIRE(record.field(1).at(1).is_object());
+	REQUIRE(record.property("env").property("k").as_string() == "v");
+	REQUIRE(!record.field(3).exists());
+	REQUIRE(!record.field(4).exists());
+	REQUIRE(!record.property("other").exists());
+
+	using jsonish::ErrorCode;
+	auto const error_of = [&schema](std::string_view str) {
+		auto result = jsonish::parse(str, schema);
+		REQUIRE(!result.is_valid());
+		return result.errors().front().code;
+	};
+
+	REQUIRE(
+		error_of(R"({"name" : "a", "paths" : [], "other" : ""})")
+			== ErrorCode::unknown_key);
+	REQUIRE(
+		error_of(R"({"name" : [], "paths" : []})")
+			== ErrorCode::wrong_kind);
+	REQUIRE(
+		error_of(R"({"name" : "a", "paths" : [], "env" : "x"})")
+			== ErrorCode::wrong_kind);
+	REQUIRE(error_of(R"({"name" : "a"})") == ErrorCode::missing_member);
+	REQUIRE(
+		error_of(R"({"name" : "a", "name" : "b", "paths" : []})")
+			== ErrorCode::duplicate_key);
+	REQUIRE(
+		error_of(R"({"name" : "a", "paths" : [],})")
+			== ErrorCode::expected_key);
+	REQUIRE(
+		error_of(R"({"name" : "a", "paths" : []} {})")
+			== ErrorCode::trailing_characters);
+	REQUIRE(error_of(R"(["name"])") == ErrorCode::expected_lbrace);
+	REQUIRE(error_of(R"({"name" : ])") == ErrorCode::expected_value);
+
+	// The failing value is reported, not the key.
+	auto r1 = jsonish::parse(R"({"name" : []})", schema);
+	REQUIRE(r1.errors().front().position.offset == 10);
+}
+
+TEST_CASE("Apply limits when parsing with a schema", "[schema]")
+{
+	jsonish::Schema const schema({
+		{"name", jsonish::ValueKind::string},
+		{"paths", jsonish::ValueKind::list}});
+	auto const text = std::string_view(R"({"name" : "a", "paths" : ["b"]})");
+
+	jsonish::ParseOptions options;
+	options.limits.max_input_bytes = 5;
+	auto const r0 = jsonish::parse(text, schema, options);
+	REQUIRE(!r0.is_valid());
+	REQUIRE(r0.errors().size() == 1);
+	REQUIRE(r0.errors()[0].code == jsonish::ErrorCode::input_too_large);
+	REQUIRE(r0.errors()[0].position.offset == 5);
+
+	// The record and every value in it count, as for a whole document.
+	options = {};
+	options.limits.max_nodes = 4;
+	REQUIRE(jsonish::parse(text, schema, options).is_valid());
+	options.limits.max_nodes = 3;
+	auto const r1 = jsonish::parse(text, schema, options);
+	REQUIRE(!r1.is_valid());
+	REQUIRE(r1.errors()[0].code == jsonish::ErrorCode::too_many_nodes);
+	REQUIRE(r1.errors()[0].position.offset == 26);
+
+	options = {};
+	options.limits.max_depth = 1;
+	auto const r2 = jsonish::parse(text, schema, options);
+	REQUIRE(!r2.is_valid());
+	REQUIRE(r2.errors()[0].code == jsonish::ErrorCode::too_deep);
+	REQUIRE(r2.errors()[0].position.offset == 25);
+}
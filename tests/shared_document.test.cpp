@@ -0,0 +1,87 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/shared_document.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Read and replace a shared document", "[shared_document]")
+{
+	jsonish::SharedDocument document(
+		jsonish::parse(R"({"version" : "1"})").value());
+	REQUIRE(document.read()->property("version").as_string() == "1");
+
+	auto const kept = document.snapshot();
+	{
+		auto const reader = document.read();
+		REQUIRE(reader.value() == kept);
+		REQUIRE((*reader).is_object());
+	}
+
+	document.store(jsonish::parse(R"({"version" : "2"})").value());
+	REQUIRE(document.read()->property("version").as_string() == "2");
+
+	// A snapshot keeps the tree it was taken from.
+	REQUIRE(kept.property("version").as_string() == "1");
+
+	jsonish::SharedDocument const empty;
+	REQUIRE(empty.snapshot() == jsonish::Value());
+}
+
+TEST_CASE("Replace a shared document while it is read", "[shared_document]")
+{
+	// Each version holds its number twice, which readers check agree.
+	auto const version = [](int n)
+	{
+		auto const text = std::to_string(n) + std::string(20, '.');
+		jsonish::Object object;
+		object.set_property("a", text);
+		object.set_property("b", jsonish::List());
+		object.set_property("c", text);
+		return jsonish::Value(std::move(object));
+	};
+
+	jsonish::SharedDocument document(version(0));
+	std::atomic<bool> stop{false};
+	std::atomic<bool> consistent{true};
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; ++i)
+	{
+		readers.emplace_back([&]()
+		{
+			while (!stop.load())
+			{
+				auto const reader = document.read();
+				if (reader->property("a").as_string()
+					!= reader->property("c").as_string())
+				{
+					consistent = false;
+				}
+				auto const kept = document.snapshot();
+				if (!kept.property("b").is_list())
+				{
+					consistent = false;
+				}
+			}
+		});
+	}
+
+	for (int n = 1; n <= 100; ++n)
+	{
+		document.store(version(n));
+	}
+	stop = true;
+	for (auto& reader : readers)
+	{
+		reader.join();
+	}
+
+	REQUIRE(consistent.load());
+	REQUIRE(
+		document.read()->property("a").as_string()
+			== "100" + std::string(20, '.'));
+}
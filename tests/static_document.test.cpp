@@ -0,0 +1,84 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/static_document.hpp"
+
+#include <catch2/catch.hpp>
+
+static constexpr auto defaults = JSONISH_STATIC_DOCUMENT(R"({
+	"name" : "default",
+	"paths" : ["/usr/share", "/etc"],
+	"escapes" : "tab\there ¬ 😀",
+	"nested" : {"empty list" : [], "empty object" : {}}
+})");
+
+// Everything here is checked during compilation.
+static_assert(defaults.root().is_object());
+static_assert(defaults.root().size() == 4);
+static_assert(defaults.property("name").as_string() == "default");
+static_assert(defaults.property("paths").is_list());
+static_assert(defaults.property("paths").at(1).as_string() == "/etc");
+static_assert(!defaults.property("paths").at(2).exists());
+static_assert(!defaults.property("missing").exists());
+static_assert(
+	defaults.property("escapes").as_string() == "tab\there ¬ 😀");
+static_assert(defaults.property("nested").property("empty list").is_list());
+static_assert(defaults.at(3).key() == "nested");
+
+static constexpr auto top_level_string = JSONISH_STATIC_DOCUMENT(R"("")");
+static_assert(top_level_string.root().as_string().empty());
+
+TEST_CASE("Build static documents", "[static_document]")
+{
+	auto const runtime = jsonish::parse(R"({
+		"name" : "default",
+		"paths" : ["/usr/share", "/etc"],
+		"escapes" : "tab\there ¬ 😀",
+		"nested" : {"empty list" : [], "empty object" : {}}
+	})");
+	REQUIRE(runtime.is_valid());
+	REQUIRE(defaults.to_value() == runtime.value());
+
+	REQUIRE(defaults.property("paths").to_value().as_list().size() == 2);
+	REQUIRE_THROWS(defaults.property("missing").to_value());
+}
+
+TEST_CASE("Reject malformed static documents", "[static_document]")
+{
+	auto const code_of = [](std::string_view literal) {
+		try
+		{
+			(void)jsonish::measure_static_document(literal);
+		}
+		catch (jsonish::StaticParseError const& e)
+		{
+			return e.code();
+		}
+		FAIL("no error for " << literal);
+		return jsonish::ErrorCode::expected_value;
+	};
+
+	using jsonish::ErrorCode;
+	REQUIRE(code_of("") == ErrorCode::expected_value);
+	REQUIRE(code_of("{") == ErrorCode::expected_key);
+	REQUIRE(code_of(R"({"a" "b"})") == ErrorCode::expected_colon);
+	REQUIRE(code_of(R"(["a",])") == ErrorCode::expected_value);
+	REQUIRE(code_of(R"(["a")") == ErrorCode::expected_rbracket);
+	REQUIRE(code_of(R"("a" "b")") == ErrorCode::trailing_characters);
+	REQUIRE(code_of(R"("\x")") == ErrorCode::invalid_escape_sequence);
+	REQUIRE(code_of(R"("\u12g4")") == ErrorCode::expected_hex_digit);
+	REQUIRE(code_of(R"("abc)") == ErrorCode::no_closing_quote);
+
+	// Duplicate keys are only found once keys are stored.
+	try
+	{
+		(void)jsonish::StaticDocument<3, 2>(R"({"a" : "", "a" : ""})");
+		FAIL("no error for duplicate key");
+	}
+	catch (jsonish::StaticParseError const& e)
+	{
+		REQUIRE(e.code() == ErrorCode::duplicate_key);
+		REQUIRE(e.offset() == 11);
+	}
+
+	REQUIRE_THROWS_AS(
+		(jsonish::StaticDocument<1, 0>("\"a\"")), std::length_error);
+}
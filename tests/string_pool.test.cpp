@@ -0,0 +1,78 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/string_pool.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+
+TEST_CASE("Share equal strings through a pool", "[string_pool]")
+{
+	jsonish::StringPool pool;
+	auto const a0 = pool.intern("a string too long to be stored inline");
+	auto const a1 = pool.intern("a string too long to be stored inline");
+	auto const b0 = pool.intern("another string too long to be inline");
+	REQUIRE(a0 == a1);
+	REQUIRE(a0.shares_storage_with(a1));
+	REQUIRE(!a0.shares_storage_with(b0));
+
+	// Short strings are stored inline, so they are not pooled.
+	auto const c0 = pool.intern("short");
+	REQUIRE(c0 == "short");
+	REQUIRE(pool.size() == 2);
+	REQUIRE(pool.stats().strings == 3);
+	REQUIRE(pool.stats().shared == 1);
+	REQUIRE(pool.stats().bytes_saved > a0.as_string().size());
+
+	// Values keep their strings after the pool is cleared.
+	pool.clear();
+	REQUIRE(pool.size() == 0);
+	REQUIRE(pool.stats().strings == 0);
+	REQUIRE(a1.as_string() == "a string too long to be stored inline");
+
+	// Enough strings to make the table grow.
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto const value = pool.intern(
+			"string number " + std::to_string(i % 300) + " of many");
+		REQUIRE(
+			value.as_string()
+				== "string number " + std::to_string(i % 300) + " of many");
+	}
+	REQUIRE(pool.size() == 300);
+	REQUIRE(pool.stats().shared == 700);
+}
+
+TEST_CASE("Parse with a string pool", "[string_pool]")
+{
+	std::string text = "[";
+	for (int i = 0; i < 100; ++i)
+	{
+		text += i == 0 ? "" : ", ";
+		text += R"({"state" : "waiting for a response", "kind" : "short", )"
+			R"("id" : "record with a long identifier )"
+			+ std::to_string(i) + "\"}";
+	}
+	text += "]";
+
+	jsonish::StringPool pool;
+	auto const pooled = jsonish::parse(text, pool);
+	REQUIRE(pooled.is_valid());
+	REQUIRE(pooled.value() == jsonish::parse(text).value());
+	REQUIRE(pool.size() == 101);
+	REQUIRE(pool.stats().strings == 200);
+	REQUIRE(pool.stats().shared == 99);
+
+	auto const& list = pooled.value().as_list();
+	auto const first = list.at(0).property("state").as_value();
+	auto const last = list.at(99).property("state").as_value();
+	REQUIRE(first.shares_storage_with(last));
+	REQUIRE(
+		!list.at(0).property("id").as_value().shares_storage_with(
+			list.at(1).property("id").as_value()));
+
+	// Errors are the same as without a pool.
+	auto const invalid = jsonish::parse(R"(["a", "b")", pool);
+	REQUIRE(!invalid.is_valid());
+	REQUIRE(
+		invalid.errors()[0].code == jsonish::ErrorCode::expected_rbracket);
+}
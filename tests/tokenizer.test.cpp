@@ -0,0 +1,77 @@
+#include "jsonish/tokenizer.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("Tokenize into compact tokens", "[tokenizer]")
+{
+	using jsonish::TokenKind;
+
+	jsonish::Tokenizer t;
+	std::string const s0 = R"( {"key" : ["plain", "esc\"apedé"]} )";
+	REQUIRE(t.tokenize(s0));
+	REQUIRE(!t.error().has_value());
+
+	std::vector<TokenKind> kinds;
+	for (auto const& token : t.tokens())
+	{
+		kinds.push_back(token.kind);
+	}
+	REQUIRE(kinds == std::vector<TokenKind>{
+		TokenKind::lbrace, TokenKind::string, TokenKind::colon,
+		TokenKind::lbracket, TokenKind::string, TokenKind::comma,
+		TokenKind::string, TokenKind::rbracket, TokenKind::rbrace});
+
+	auto const& key = t.tokens()[1];
+	REQUIRE(key.offset == 2);
+	REQUIRE(key.length == 5);
+	REQUIRE(!key.has_escapes);
+	REQUIRE(t.raw(key) == R"("key")");
+	REQUIRE(t.contents(key) == "key");
+	REQUIRE(t.text(key) == "key");
+
+	auto const& escaped = t.tokens()[6];
+	REQUIRE(escaped.has_escapes);
+	REQUIRE(t.contents(escaped) == R"(esc\"apedé)");
+	REQUIRE(t.text(escaped) == "esc\"apedé");
+
+	std::string out = "prefix ";
+	t.decode(t.tokens()[4], out);
+	REQUIRE(out == "prefix plain");
+
+	// The buffer is replaced by the next input.
+	REQUIRE(t.tokenize("[]"));
+	REQUIRE(t.tokens().size() == 2);
+	REQUIRE(t.tokenize(""));
+	REQUIRE(t.tokens().empty());
+}
+
+TEST_CASE("Report tokenizer errors", "[tokenizer]")
+{
+	jsonish::Tokenizer t;
+	REQUIRE(!t.tokenize(R"(["a", b])"));
+	REQUIRE(t.tokens().size() == 3);
+	REQUIRE(t.error()->code == jsonish::ErrorCode::unexpected_character);
+	REQUIRE(t.error()->position.offset == 6);
+
+	REQUIRE(!t.tokenize(R"(["a\q"])"));
+	REQUIRE(t.tokens().size() == 1);
+	REQUIRE(t.error()->code == jsonish::ErrorCode::invalid_escape_sequence);
+	REQUIRE(t.error()->position.offset == 1);
+
+	REQUIRE(!t.tokenize(R"("unterminated)"));
+	REQUIRE(t.error()->code == jsonish::ErrorCode::no_closing_quote);
+
+	// Tokenizing again clears the error.
+	REQUIRE(t.tokenize("{}"));
+	REQUIRE(!t.error().has_value());
+
+	jsonish::ParseOptions strict;
+	strict.validate_utf8 = true;
+	jsonish::Tokenizer s(strict);
+	REQUIRE(!s.tokenize("\"\xff\""));
+	REQUIRE(s.error()->code == jsonish::ErrorCode::invalid_utf8);
+	REQUIRE(t.tokenize("\"\xff\""));
+}
@@ -0,0 +1,205 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/tree.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+TEST_CASE("Keep object members sorted", "[tree]")
+{
+	jsonish::Object o;
+	REQUIRE(o.try_insert("b", "1"));
+	REQUIRE(o.try_insert("d", "2"));
+	REQUIRE(o.try_insert("a", "3"));
+	REQUIRE(o.try_insert("c", "4"));
+	REQUIRE(!o.try_insert("a", "5"));
+	o.set_property("d", "6");
+	o.set_property("e", "7");
+
+	std::vector<std::string> keys;
+	for (auto const& [key, value] : o)
+	{
+		keys.push_back(key);
+	}
+	REQUIRE(keys == std::vector<std::string>{"a", "b", "c", "d", "e"});
+
+	// Members cannot be changed through iterators, which would unsort them.
+	static_assert(std::is_const_v<
+		std::remove_reference_t<decltype(*std::begin(o))>>);
+
+	REQUIRE(o.property("a").as_string() == "3");
+	REQUIRE(o.property("d").as_string() == "6");
+	REQUIRE(!o.property("f").exists());
+
+	// Insertion order does not affect equality.
+	jsonish::Object p;
+	p.set_property("e", "7");
+	p.set_property("d", "6");
+	p.set_property("c", "4");
+	p.set_property("b", "1");
+	p.set_property("a", "3");
+	REQUIRE(o == p);
+}
+
+TEST_CASE("Look up properties with key handles", "[tree]")
+{
+	jsonish::KeyHandle const id("id");
+	jsonish::KeyHandle const name("name");
+	jsonish::KeyHandle const missing("missing");
+	REQUIRE(id.key() == "id");
+	REQUIRE(id.hash() != name.hash());
+
+	auto const v0 = jsonish::parse(
+		R"([{"id": "1", "name": "a", "x": ""},)"
+		R"( {"id": "2", "name": "b", "x": ""},)"
+		R"( {"name": "c", "id": "3", "a": "", "b": ""},)"
+		R"( {"x": "4"}, "5"])").value();
+
+	auto const& list = v0.as_list();
+	REQUIRE(list.at(0).property(id).as_string() == "1");
+	REQUIRE(list.at(0).property(name).as_string() == "a");
+	REQUIRE(list.at(1).property(id).as_string() == "2");
+	REQUIRE(list.at(1).property(name).as_string() == "b");
+
+	// A differently shaped object moves the key, so the hint is wrong.
+	REQUIRE(list.at(2).property(id).as_string() == "3");
+	REQUIRE(list.at(2).property(name).as_string() == "c");
+	REQUIRE(list.at(0).property(id).as_string() == "1");
+
+	REQUIRE(!list.at(3).property(id).exists());
+	REQUIRE(!list.at(0).property(missing).exists());
+	REQUIRE(!list.at(4).property(id).exists());
+	REQUIRE(!list.at(5).property(id).exists());
+
+	jsonish::KeyHandle const copy = name;
+	REQUIRE(list.at(1).property(copy).as_string() == "b");
+}
+
+TEST_CASE("Find members with every object storage", "[tree]")
+{
+	auto const storage = GENERATE(
+		jsonish::ObjectStorage::automatic,
+		jsonish::ObjectStorage::sorted,
+		jsonish::ObjectStorage::hashed);
+
+	// Keys are inserted out of order to exercise sorting.
+	std::vector<std::pair<std::string, jsonish::Value>> members;
+	for (int i = 0; i < 100; ++i)
+	{
+		auto const n = (i * 37) % 100;
+		members.emplace_back("key" + std::to_string(n), std::to_string(n));
+	}
+
+	jsonish::Object o(storage);
+	REQUIRE(o.storage() == storage);
+	REQUIRE(!o.assign(std::move(members)));
+	REQUIRE(o.size() == 100);
+	REQUIRE(o.is_hashed() == (storage != jsonish::ObjectStorage::sorted));
+	REQUIRE(std::is_sorted(
+		o.begin(), o.end(),
+		[](auto const& a, auto const& b) { return a.first < b.first; }));
+
+	for (int n = 0; n < 100; ++n)
+	{
+		auto const key = "key" + std::to_string(n);
+		REQUIRE(o.property(key).as_string() == std::to_string(n));
+		REQUIRE(
+			o.property(jsonish::KeyHandle(key)).as_string()
+				== std::to_string(n));
+	}
+	REQUIRE(!o.property("key100").exists());
+
+	// Members inserted later are found as well.
+	REQUIRE(o.try_insert("a", "first"));
+	REQUIRE(o.try_insert("zzz", "last"));
+	REQUIRE(!o.try_insert("key5", "again"));
+	REQUIRE(o.property("a").as_string() == "first");
+	REQUIRE(o.property("zzz").as_string() == "last");
+	REQUIRE(o.property("key50").as_string() == "50");
+
+	// Storage does not affect equality.
+	jsonish::Object sorted(jsonish::ObjectStorage::sorted);
+	for (auto const& [key, value] : o)
+	{
+		sorted.set_property(key, value);
+	}
+	REQUIRE(sorted == o);
+}
+
+TEST_CASE("Hash objects once they are wide", "[tree]")
+{
+	jsonish::Object o;
+	for (std::size_t i = 0; i < jsonish::hashed_object_threshold; ++i)
+	{
+		REQUIRE(!o.is_hashed());
+		o.set_property(std::to_string(i), "");
+	}
+	REQUIRE(o.is_hashed());
+	for (std::size_t i = 0; i < jsonish::hashed_object_threshold; ++i)
+	{
+		REQUIRE(o.property(std::to_string(i)).exists());
+	}
+}
+
+TEST_CASE("Report the first repeated key when assigning", "[tree]")
+{
+	jsonish::Object o;
+	REQUIRE(o.try_insert("old", ""));
+
+	std::vector<std::pair<std::string, jsonish::Value>> members{
+		{"c", ""}, {"a", ""}, {"b", ""}, {"a", ""}, {"c", ""}};
+	REQUIRE(o.assign(std::move(members)) == std::optional<std::size_t>(3));
+	REQUIRE(o.is_empty());
+
+	std::vector<std::pair<std::string, jsonish::Value>> sorted_members{
+		{"a", ""}, {"b", ""}, {"b", ""}};
+	REQUIRE(
+		o.assign(std::move(sorted_members))
+			== std::optional<std::size_t>(2));
+}
+
+TEST_CASE("Store values compactly", "[tree]")
+{
+	REQUIRE(sizeof(jsonish::Value) == 16);
+
+	jsonish::Value const empty;
+	REQUIRE(empty.is_string());
+	REQUIRE(empty.as_string().empty());
+
+	// Strings up to 15 bytes are inline, longer ones are in a node.
+	jsonish::Value const short_string("fifteen bytes!!");
+	jsonish::Value const long_string(std::string("sixteen bytes!!!"));
+	REQUIRE(short_string.as_string() == "fifteen bytes!!");
+	REQUIRE(long_string.as_string() == "sixteen bytes!!!");
+	REQUIRE(short_string != long_string);
+	REQUIRE(jsonish::Value("sixteen bytes!!!") == long_string);
+	REQUIRE_THROWS_AS(short_string.as_list(), std::bad_variant_access);
+	REQUIRE_THROWS_AS(long_string.as_object(), std::bad_variant_access);
+
+	jsonish::List list;
+	list.append(long_string);
+	list.append(jsonish::Object{});
+	jsonish::Value const original(std::move(list));
+	REQUIRE_THROWS_AS(original.as_string(), std::bad_variant_access);
+
+	// Copies share the same list.
+	auto copy = original;
+	REQUIRE(&copy.as_list() == &original.as_list());
+	REQUIRE(copy == original);
+	copy = copy;
+	REQUIRE(copy.as_list().size() == 2);
+
+	auto moved = std::move(copy);
+	REQUIRE(&moved.as_list() == &original.as_list());
+	REQUIRE(copy.is_string());
+
+	moved = short_string;
+	REQUIRE(moved == short_string);
+	REQUIRE(original.as_list().at(0).as_string() == "sixteen bytes!!!");
+	REQUIRE(original.as_list().at(1).is_object());
+}
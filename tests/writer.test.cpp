@@ -0,0 +1,126 @@
+#include "jsonish/parse.hpp"
+#include "jsonish/writer.hpp"
+
+#include <catch2/catch.hpp>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+TEST_CASE("Write documents", "[writer]")
+{
+	jsonish::Writer w0;
+	w0.begin_object()
+		.key("b").string("x")
+		.key("a").begin_list()
+			.string("y").begin_object().end_object().begin_list().end_list()
+		.end_list()
+		.key("c").begin_object().key("d").string("").end_object()
+		.end_object();
+	REQUIRE(w0.is_done());
+	REQUIRE(w0.depth() == 0);
+	REQUIRE(
+		w0.output() == R"({"b":"x","a":["y",{},[]],"c":{"d":""}})");
+	REQUIRE(jsonish::parse(w0.output()).is_valid());
+
+	// Strings are escaped so that they parse back to the same text.
+	std::string const text = "quote \" backslash \\ tab \t nul "
+		+ std::string(1, '\0') + " bell \x07 raw é";
+	jsonish::Writer w1;
+	w1.begin_list().string(text).end_list();
+	REQUIRE(
+		w1.output()
+			== "[\"quote \\\" backslash \\\\ tab \\t nul \\u0000 "
+			"bell \\u0007 raw é\"]");
+	REQUIRE(
+		jsonish::parse(w1.output()).value().at(0).as_string() == text);
+
+	auto const value = jsonish::parse(
+		R"({"z" : ["a", {"y" : "b"}], "x" : "line\nbreak"})").value();
+	jsonish::Writer w2;
+	w2.value(value);
+	REQUIRE(w2.output() == R"({"x":"line\nbreak","z":["a",{"y":"b"}]})");
+	REQUIRE(jsonish::parse(w2.take_output()).value() == value);
+	REQUIRE(w2.output().empty());
+
+	jsonish::Writer w3;
+	w3.string("top");
+	REQUIRE(w3.is_done());
+	REQUIRE(w3.output() == "\"top\"");
+}
+
+TEST_CASE("Check the nesting of written documents", "[writer]")
+{
+	jsonish::Writer w0;
+	w0.begin_object();
+	REQUIRE_THROWS_AS(w0.string("no key"), std::logic_error);
+	REQUIRE_THROWS_AS(w0.end_list(), std::logic_error);
+	w0.key("a");
+	REQUIRE_THROWS_AS(w0.key("b"), std::logic_error);
+	REQUIRE_THROWS_AS(w0.end_object(), std::logic_error);
+	w0.begin_list();
+	REQUIRE_THROWS_AS(w0.key("c"), std::logic_error);
+	REQUIRE_THROWS_AS(w0.end_object(), std::logic_error);
+	w0.end_list().end_object();
+	REQUIRE_THROWS_AS(w0.string("second"), std::logic_error);
+	REQUIRE_THROWS_AS(w0.end_object(), std::logic_error);
+
+	// Failed calls write nothing.
+	REQUIRE(w0.output() == R"({"a":[]})");
+
+	jsonish::Writer w1;
+	REQUIRE_THROWS_AS(w1.key("a"), std::logic_error);
+	REQUIRE(!w1.is_done());
+}
+
+#ifndef _WIN32
+TEST_CASE("Write documents to a file descriptor", "[writer]")
+{
+	auto* const file = std::tmpfile();
+	REQUIRE(file != nullptr);
+
+	// A tiny chunk size makes every kind of write happen.
+	std::string const long_string(100, 'x');
+	{
+		jsonish::Writer w0(fileno(file), 16);
+		w0.begin_list();
+		for (int i = 0; i < 20; ++i)
+		{
+			w0.string(std::to_string(i)).string(long_string);
+		}
+		w0.begin_object().key(long_string).string("\n").end_object();
+		w0.end_list();
+		REQUIRE(w0.output().empty());
+	}
+
+	std::string expected = "[";
+	for (int i = 0; i < 20; ++i)
+	{
+		expected += "\"" + std::to_string(i) + "\",\"" + long_string + "\",";
+	}
+	expected += "{\"" + long_string + "\":\"\\n\"}]";
+
+	std::rewind(file);
+	std::string written;
+	char chunk[256];
+	while (auto const count = std::fread(chunk, 1, sizeof chunk, file))
+	{
+		written.append(chunk, count);
+	}
+	std::fclose(file);
+	REQUIRE(written == expected);
+
+	// Writing to a closed descriptor fails.
+	int fds[2];
+	REQUIRE(::pipe(fds) == 0);
+	::close(fds[1]);
+	jsonish::Writer w1(fds[1]);
+	REQUIRE_THROWS_AS(w1.string("x"), std::system_error);
+	::close(fds[0]);
+}
+#endif